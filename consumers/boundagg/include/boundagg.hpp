@@ -4,6 +4,7 @@
 #include <string>
 #include <eosio/crypto.hpp>
 #include <eosio/system.hpp>
+#include <eosio/singleton.hpp>
 
 using namespace eosio;
 using namespace std;
@@ -13,11 +14,23 @@ using namespace std;
 #define ORCHESTRATOR_CONTRACT "orchyyyyyyyy"
 #define SUBSCRIPTION_CONTRACT "subsyyyyyyyy"
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
+#define NEW_BADGE_BATCH_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifybatch"
+#define NEW_BADGE_COMPACT_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachv2"
+
+// (seq, badge) inserts or sequence transitions done by the action that starts a bulk job
+#define BULK_CHUNK_UNITS 50
 
 CONTRACT boundagg : public contract {
 public:
     using contract::contract;
 
+    struct achievement_event {
+        asset badge_asset;
+        name from;
+        name to;
+        string memo;
+    };
+
     [[eosio::on_notify(NEW_BADGE_ISSUANCE_NOTIFICATION)]] void notifyachiev(
     name org,
     asset badge_asset, 
@@ -26,6 +39,20 @@ public:
     string memo, 
     vector<name> notify_accounts);
 
+    [[eosio::on_notify(NEW_BADGE_BATCH_NOTIFICATION)]] void notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events);
+
+    [[eosio::on_notify(NEW_BADGE_COMPACT_NOTIFICATION)]] void notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash);
 
     ACTION initagg(name org, symbol agg_symbol, vector<symbol> init_badge_symbols, string agg_description);
     ACTION addinitbadge(name org, symbol agg_symbol, vector<symbol> badge_symbols);
@@ -52,6 +79,10 @@ public:
     ACTION resumebadge(name org, symbol agg_symbol, uint64_t badge_agg_seq_id);
     ACTION resumebadges(name org, symbol agg_symbol, uint64_t seq_id, vector<symbol> badge_symbols);
 
+    ACTION migratebs(name org, uint16_t max_rows);
+
+    ACTION runjob(name org, uint64_t job_id, uint16_t max_units);
+
     
 private:
     // scoped by agg symbol
@@ -87,21 +118,21 @@ private:
         uint64_t seq_id;           // The sequence ID this badge is associated with
         symbol badge_symbol;       // The symbol representing the badge
         name badge_status;         // The status of the badge (e.g., "active")
-        name seq_status;           // The status of the sequence copied from the sequence table
+        name seq_status;           // The status of the sequence copied from the sequence table, legacy model only
 
         uint64_t primary_key() const { return badge_agg_seq_id; }
         uint128_t by_agg_seq() const { return combine_keys(agg_symbol.code().raw(), seq_id); }
 
-        checksum256 by_badge_status() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
-            return sha256(data.data(), data.size());
+        // secondary keys pack the raw values into the words of a checksum256, nothing is hashed
+        checksum256 by_badge_status() const { return badge_status_key(badge_symbol, badge_status, seq_status); }
+        checksum256 by_agg_seq_badge() const { return agg_seq_badge_key(agg_symbol, seq_id, badge_symbol); }
+
+        static checksum256 badge_status_key(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
+            return checksum256::make_from_word_sequence<uint64_t>(badge_symbol.code().raw(), badge_status.value, seq_status.value, uint64_t(0));
         }
 
-        checksum256 by_agg_seq_badge() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = agg_symbol.code().to_string() + std::to_string(seq_id) + badge_symbol.code().to_string();
-            return sha256(data.data(), data.size());
+        static checksum256 agg_seq_badge_key(const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+            return checksum256::make_from_word_sequence<uint64_t>(agg_symbol.code().raw(), seq_id, badge_symbol.code().raw(), uint64_t(0));
         }
 
         static uint128_t combine_keys(uint64_t a, uint64_t b) {
@@ -115,6 +146,181 @@ private:
         eosio::indexed_by<"aggseqbadge"_n, eosio::const_mem_fun<badgestatus, checksum256, &badgestatus::by_agg_seq_badge>>
     > badgestatus_table;
 
+    // scoped by boundagg contract, rows past last_badge_agg_seq_id still carry the legacy sha256 keys until done
+    struct [[eosio::table]] bsmigration {
+        name org;
+        uint64_t last_badge_agg_seq_id;
+        bool done;
+        auto primary_key() const { return org.value; }
+    };
+    typedef multi_index<name("bsmigration"), bsmigration> bsmigration_table;
+
+    bool badgestatus_migrated(name org) {
+        bsmigration_table _bsmigration(get_self(), get_self().value);
+        auto bsmigration_itr = _bsmigration.find(org.value);
+        return bsmigration_itr != _bsmigration.end() && bsmigration_itr->done;
+    }
+
+    struct routeentry {
+        uint64_t badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+    };
+
+    // scoped by org, the (badge, sequence) pairs issuances of badge_symbol are recorded under.
+    // kept in step with every badge and sequence status change, an entry exists while both are active.
+    struct [[eosio::table]] activeroute {
+        symbol badge_symbol;
+        vector<routeentry> routes;
+        auto primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<name("activeroutes"), activeroute> activeroute_table;
+
+    // adds or removes route in the activeroute row of badge_symbol, the row is erased once empty
+    void set_active_route(name org, const symbol& badge_symbol, const routeentry& route, bool active) {
+        activeroute_table _activeroute(get_self(), org.value);
+        auto activeroute_itr = _activeroute.find(badge_symbol.code().raw());
+        if(activeroute_itr == _activeroute.end()) {
+            if(active) {
+                _activeroute.emplace(get_self(), [&](auto& entry) {
+                    entry.badge_symbol = badge_symbol;
+                    entry.routes.push_back(route);
+                });
+            }
+            return;
+        }
+        auto& routes = activeroute_itr->routes;
+        auto route_itr = std::find_if(routes.begin(), routes.end(), [&](const routeentry& entry) {
+            return entry.badge_agg_seq_id == route.badge_agg_seq_id;
+        });
+        if(active == (route_itr != routes.end())) {
+            return;
+        }
+        if(!active && routes.size() == 1) {
+            _activeroute.erase(activeroute_itr);
+            return;
+        }
+        auto route_index = route_itr - routes.begin();
+        _activeroute.modify(activeroute_itr, get_self(), [&](auto& entry) {
+            if(active) {
+                entry.routes.push_back(route);
+            } else {
+                entry.routes.erase(entry.routes.begin() + route_index);
+            }
+        });
+    }
+
+    bool sequence_active(const symbol& agg_symbol, uint64_t seq_id) {
+        sequence_table sequence_t(get_self(), agg_symbol.code().raw());
+        auto sequence_itr = sequence_t.find(seq_id);
+        return sequence_itr != sequence_t.end() && sequence_itr->seq_status == "active"_n;
+    }
+
+    // scoped by org, the init badges a sequence of a migrated org inherits, recorded by initseq
+    // with one id block. inherited badge i has badge_agg_seq_id first_badge_agg_seq_id + i and
+    // only gets a badgestatus row when its status is overridden.
+    struct [[eosio::table]] seqinherit {
+        uint64_t first_badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+        vector<symbol> badge_symbols;
+        uint64_t primary_key() const { return first_badge_agg_seq_id; }
+        uint128_t by_agg_seq() const { return badgestatus::combine_keys(agg_symbol.code().raw(), seq_id); }
+    };
+    typedef multi_index<name("seqinherits"), seqinherit,
+        indexed_by<"byaggseq"_n, const_mem_fun<seqinherit, uint128_t, &seqinherit::by_agg_seq>>
+    > seqinherit_table;
+
+    vector<symbol> inherited_badge_symbols(name org, const symbol& agg_symbol, uint64_t seq_id) {
+        seqinherit_table _seqinherit(get_self(), org.value);
+        auto by_agg_seq_index = _seqinherit.get_index<"byaggseq"_n>();
+        auto itr = by_agg_seq_index.find(badgestatus::combine_keys(agg_symbol.code().raw(), seq_id));
+        return itr == by_agg_seq_index.end() ? vector<symbol>() : itr->badge_symbols;
+    }
+
+    // badge_agg_seq_id the sequence reserved for badge_symbol, 0 if it does not inherit it
+    uint64_t inherited_badge_agg_seq_id(name org, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+        seqinherit_table _seqinherit(get_self(), org.value);
+        auto by_agg_seq_index = _seqinherit.get_index<"byaggseq"_n>();
+        auto itr = by_agg_seq_index.find(badgestatus::combine_keys(agg_symbol.code().raw(), seq_id));
+        if(itr == by_agg_seq_index.end()) {
+            return 0;
+        }
+        auto badge_itr = std::find(itr->badge_symbols.begin(), itr->badge_symbols.end(), badge_symbol);
+        if(badge_itr == itr->badge_symbols.end()) {
+            return 0;
+        }
+        return itr->first_badge_agg_seq_id + (badge_itr - itr->badge_symbols.begin());
+    }
+
+    // the seqinherit row whose id block holds badge_agg_seq_id, end() if there is none
+    seqinherit_table::const_iterator find_inherit_block(seqinherit_table& _seqinherit, uint64_t badge_agg_seq_id) {
+        auto itr = _seqinherit.upper_bound(badge_agg_seq_id);
+        if(itr == _seqinherit.begin()) {
+            return _seqinherit.end();
+        }
+        itr--;
+        if(badge_agg_seq_id - itr->first_badge_agg_seq_id >= itr->badge_symbols.size()) {
+            return _seqinherit.end();
+        }
+        return itr;
+    }
+
+    // brings the activeroute rows of every badge of the sequence in line with its status,
+    // one row write per badge. badges with a badgestatus row follow their badge status,
+    // inherited badges without one are active.
+    void route_sequence(name org, const symbol& agg_symbol, uint64_t seq_id, bool seq_active) {
+        badgestatus_table badgestatus_t(get_self(), org.value);
+        auto index = badgestatus_t.get_index<"byaggseq"_n>();
+        auto itr = index.find(badgestatus::combine_keys(agg_symbol.code().raw(), seq_id));
+        vector<symbol> row_badge_symbols;
+        while(itr != index.end() && itr->agg_symbol == agg_symbol && itr->seq_id == seq_id) {
+            set_active_route(org, itr->badge_symbol, {itr->badge_agg_seq_id, agg_symbol, seq_id}, seq_active && itr->badge_status == "active"_n);
+            row_badge_symbols.push_back(itr->badge_symbol);
+            itr++;
+        }
+
+        seqinherit_table _seqinherit(get_self(), org.value);
+        auto by_agg_seq_index = _seqinherit.get_index<"byaggseq"_n>();
+        auto seqinherit_itr = by_agg_seq_index.find(badgestatus::combine_keys(agg_symbol.code().raw(), seq_id));
+        if(seqinherit_itr == by_agg_seq_index.end()) {
+            return;
+        }
+        for(uint64_t i = 0; i < seqinherit_itr->badge_symbols.size(); i++) {
+            auto& badge_symbol = seqinherit_itr->badge_symbols[i];
+            if(std::find(row_badge_symbols.begin(), row_badge_symbols.end(), badge_symbol) == row_badge_symbols.end()) {
+                set_active_route(org, badge_symbol, {seqinherit_itr->first_badge_agg_seq_id + i, agg_symbol, seq_id}, seq_active);
+            }
+        }
+    }
+
+    // active (badge, sequence) pairs of badge_symbol.
+    // migrated orgs: the activeroute row of the badge.
+    // other orgs: scan of the status index.
+    vector<routeentry> active_routes(name org, const symbol& badge_symbol) {
+        if(badgestatus_migrated(org)) {
+            activeroute_table _activeroute(get_self(), org.value);
+            auto activeroute_itr = _activeroute.find(badge_symbol.code().raw());
+            return activeroute_itr == _activeroute.end() ? vector<routeentry>() : activeroute_itr->routes;
+        }
+
+        vector<routeentry> routes;
+        badgestatus_table badgestatus_t(get_self(), org.value);
+        auto by_status_index = badgestatus_t.get_index<"bybadgestat"_n>();
+        vector<checksum256> keys = {
+            badgestatus::badge_status_key(badge_symbol, "active"_n, "active"_n),
+            hash_active_status(badge_symbol, "active"_n, "active"_n)};
+        for(auto& key : keys) {
+            auto itr = by_status_index.find(key);
+            while(itr != by_status_index.end() && itr->badge_symbol == badge_symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
+                routes.push_back({itr->badge_agg_seq_id, itr->agg_symbol, itr->seq_id});
+                itr++;
+            }
+        }
+        return routes;
+    }
+
+    // legacy sha256 keys, only used for rows not yet re-indexed by boundagg::migratebs
     checksum256 hash_active_status(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
         // Create a data string from badge_symbol, badge_status, and seq_status
         string data_str = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
@@ -131,6 +337,16 @@ private:
         return sha256(data_str.data(), data_str.size());
     }
 
+    // aggseqbadge lookup, falls back to the legacy key while the org is not migrated
+    template<typename Index>
+    auto find_agg_seq_badge(Index& index, bool migrated, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+        auto itr = index.find(badgestatus::agg_seq_badge_key(agg_symbol, seq_id, badge_symbol));
+        if(itr == index.end() && !migrated) {
+            itr = index.find(hash_agg_seq_badge(agg_symbol, seq_id, badge_symbol));
+        }
+        return itr;
+    }
+
     // scoped by account
     struct [[eosio::table]] achievements {
         uint64_t badge_agg_seq_id;
@@ -140,7 +356,29 @@ private:
     };
     typedef eosio::multi_index<"achievements"_n, achievements> achievements_table;
 
-    // scoped by boundagg contract
+    vector<uint64_t> active_badge_agg_seq_ids(name org, const symbol& badge_symbol) {
+        vector<uint64_t> badge_agg_seq_ids;
+        for(auto& route : active_routes(org, badge_symbol)) {
+            badge_agg_seq_ids.push_back(route.badge_agg_seq_id);
+        }
+        return badge_agg_seq_ids;
+    }
+
+    void add_achievement(achievements_table& achievements, uint64_t badge_agg_seq_id, uint64_t amount) {
+        auto ach_itr = achievements.find(badge_agg_seq_id);
+        if(ach_itr != achievements.end()) {
+            achievements.modify(ach_itr, get_self(), [&](auto& ach) {
+                ach.count += amount;
+            });
+        } else {
+            achievements.emplace(get_self(), [&](auto& ach) {
+                ach.badge_agg_seq_id = badge_agg_seq_id;
+                ach.count = amount;
+            });
+        }
+    }
+
+    // scoped by boundagg contract, legacy allocator row, only read once to seed seqalloc
     struct [[eosio::table]] aggseqinfo {
         uint64_t last_badge_agg_seq_id;
         uint64_t primary_key() const { return last_badge_agg_seq_id; }
@@ -148,6 +386,36 @@ private:
 
     typedef eosio::multi_index<"aggseqinfo"_n, aggseqinfo> aggseqinfo_tbl;
 
+    // scoped by boundagg contract
+    struct [[eosio::table]] seqalloc {
+        uint64_t last_badge_agg_seq_id;
+    };
+    typedef eosio::singleton<"seqalloc"_n, seqalloc> seqalloc_table;
+
+    // ids reserved up front, handed out by insert_record_in_badgestatus. ids left unused leave a gap.
+    struct idblock {
+        uint64_t next_id;
+        uint64_t end_id;
+    };
+
+    // reserves count consecutive badge_agg_seq_ids with a single allocator write
+    idblock reserve_badge_agg_seq_ids(uint64_t count) {
+        seqalloc_table _seqalloc(get_self(), get_self().value);
+        uint64_t last_badge_agg_seq_id = 0;
+        if(_seqalloc.exists()) {
+            last_badge_agg_seq_id = _seqalloc.get().last_badge_agg_seq_id;
+        } else {
+            aggseqinfo_tbl a_tbl(get_self(), get_self().value);
+            auto aggseqinfo = a_tbl.begin();
+            if(aggseqinfo != a_tbl.end()) {
+                last_badge_agg_seq_id = aggseqinfo->last_badge_agg_seq_id;
+                a_tbl.erase(aggseqinfo);
+            }
+        }
+        _seqalloc.set(seqalloc{last_badge_agg_seq_id + count}, get_self());
+        return idblock{last_badge_agg_seq_id + 1, last_badge_agg_seq_id + 1 + count};
+    }
+
 
 
 
@@ -234,6 +502,7 @@ private:
     }
 
 
+    // legacy model only, migrated orgs read sequence status from aggdetail
     void update_status_in_badgestatus(name org, const symbol& agg_symbol, uint64_t seq_id, const name& new_status, string failure_identifier) {
         badgestatus_table badgestatus_t(get_self(), org.value);
         auto index = badgestatus_t.get_index<"byaggseq"_n>();
@@ -247,42 +516,37 @@ private:
         }
     }
 
-    void insert_record_in_badgestatus(name org, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol, const name& seq_status, string failure_identifier) {
+    // returns the badge_agg_seq_id of the (agg, seq, badge) row, creating it if missing.
+    // a new row of an inherited badge takes the id its sequence reserved, any other new row
+    // takes its id from ids when given, otherwise a single id is reserved.
+    uint64_t insert_record_in_badgestatus(name org, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol, const name& seq_status, const name& badge_status, string failure_identifier, idblock* ids = nullptr) {
         badgestatus_table badgestatus_t(get_self(), org.value);
         auto index = badgestatus_t.get_index<"aggseqbadge"_n>();
-        auto key = hash_agg_seq_badge(agg_symbol, seq_id, badge_symbol);
-        auto itr = index.find(key);
+        bool migrated = badgestatus_migrated(org);
+        auto itr = find_agg_seq_badge(index, migrated, agg_symbol, seq_id, badge_symbol);
         if (itr != index.end() && itr->agg_symbol == agg_symbol && itr->seq_id == seq_id && itr->badge_symbol == badge_symbol) {
-            return;
+            return itr->badge_agg_seq_id;
         }
 
-        aggseqinfo_tbl a_tbl(get_self(), get_self().value);
-        auto aggseqinfo = a_tbl.begin();
-        uint64_t last_badge_agg_seq_id = 1;
-        if(aggseqinfo == a_tbl.end()) {
-            
-            a_tbl.emplace(get_self(), [&](auto& row) {
-                row.last_badge_agg_seq_id = 1;
-            }); 
-            
-        } else {
-            last_badge_agg_seq_id = aggseqinfo->last_badge_agg_seq_id + 1;
-            a_tbl.emplace(_self, [&](auto& row) {
-                row.last_badge_agg_seq_id = last_badge_agg_seq_id;
-            });
-            a_tbl.erase(aggseqinfo);
-            
+        uint64_t last_badge_agg_seq_id = migrated ? inherited_badge_agg_seq_id(org, agg_symbol, seq_id, badge_symbol) : 0;
+        if(last_badge_agg_seq_id == 0) {
+            if(ids != nullptr && ids->next_id < ids->end_id) {
+                last_badge_agg_seq_id = ids->next_id++;
+            } else {
+                last_badge_agg_seq_id = reserve_badge_agg_seq_ids(1).next_id;
+            }
         }
-        
-        
+
         badgestatus_t.emplace(get_self(), [&](auto& row) {
             row.badge_agg_seq_id = last_badge_agg_seq_id;
             row.agg_symbol = agg_symbol;
             row.seq_id = seq_id;
             row.badge_symbol = badge_symbol;
-            row.badge_status = "active"_n;
+            row.badge_status = badge_status;
             row.seq_status = seq_status;
         });
+        set_active_route(org, badge_symbol, {last_badge_agg_seq_id, agg_symbol, seq_id}, badge_status == "active"_n && seq_status == "active"_n);
+        return last_badge_agg_seq_id;
 
     }
 
@@ -317,24 +581,43 @@ private:
             });
             itr++;
         }
+
+        if(status != "active"_n && badgestatus_migrated(org)) {
+            override_inherited_badges(org, agg_symbol, seq_id, inherited_badge_symbols(org, agg_symbol, seq_id), status, failure_identifier);
+        }
+        route_sequence(org, agg_symbol, seq_id, sequence_active(agg_symbol, seq_id));
     }
 
     void update_badge_status(name org, symbol agg_symbol, uint64_t badge_agg_seq_id, name status, string failure_identifier) {
         badgestatus_table badgestatus_t(get_self(), org.value);
         auto itr = badgestatus_t.find(badge_agg_seq_id);
+        if(itr == badgestatus_t.end() && badgestatus_migrated(org)) {
+            seqinherit_table _seqinherit(get_self(), org.value);
+            auto seqinherit_itr = find_inherit_block(_seqinherit, badge_agg_seq_id);
+            check(seqinherit_itr != _seqinherit.end(), failure_identifier + "invalid badge_seq_id");
+            check(seqinherit_itr->agg_symbol == agg_symbol, failure_identifier + "agg_symbol mismatch");
+            if(status != "active"_n) {
+                symbol badge_symbol = seqinherit_itr->badge_symbols[badge_agg_seq_id - seqinherit_itr->first_badge_agg_seq_id];
+                override_inherited_badges(org, agg_symbol, seqinherit_itr->seq_id, {badge_symbol}, status, failure_identifier);
+            }
+            return;
+        }
         check(itr != badgestatus_t.end(), failure_identifier + "invalid badge_seq_id");
         check(itr->agg_symbol == agg_symbol, failure_identifier + "agg_symbol mismatch");
         badgestatus_t.modify(itr, _self, [&](auto& row) {
             row.badge_status = status;
         });
+        set_active_route(org, itr->badge_symbol, {itr->badge_agg_seq_id, agg_symbol, itr->seq_id}, status == "active"_n && sequence_active(agg_symbol, itr->seq_id));
     }
 
     void update_badge_statuses(name org, symbol agg_symbol, uint64_t seq_id, vector<symbol> badge_symbols, name status, string failure_identifier) {
         badgestatus_table badgestatus_t(get_self(), org.value);
         auto index = badgestatus_t.get_index<"aggseqbadge"_n>();
+        bool migrated = badgestatus_migrated(org);
+        bool seq_active = sequence_active(agg_symbol, seq_id);
+        vector<symbol> missing_badge_symbols;
         for(auto i = 0; i < badge_symbols.size(); i++) {
-            auto key = hash_agg_seq_badge(agg_symbol, seq_id, badge_symbols[i]);
-            auto itr = index.find(key);
+            auto itr = find_agg_seq_badge(index, migrated, agg_symbol, seq_id, badge_symbols[i]);
             if(itr != index.end() && 
                 itr->agg_symbol == agg_symbol && 
                 itr->seq_id == seq_id && 
@@ -343,11 +626,52 @@ private:
                 index.modify(itr, _self, [&](auto& row) {
                     row.badge_status = status;
                 });
+                set_active_route(org, itr->badge_symbol, {itr->badge_agg_seq_id, agg_symbol, seq_id}, status == "active"_n && seq_active);
+
+            } else {
+                missing_badge_symbols.push_back(badge_symbols[i]);
+            }
+        }
+
+        if(status != "active"_n && migrated && !missing_badge_symbols.empty()) {
+            override_inherited_badges(org, agg_symbol, seq_id, missing_badge_symbols, status, failure_identifier);
+        }
+    }
+
+    // migrated orgs keep no row for a badge their sequence inherits, so a non-active
+    // badge status is recorded by creating the row, under its reserved id, with that status
+    void override_inherited_badges(name org, const symbol& agg_symbol, uint64_t seq_id, const vector<symbol>& badge_symbols, name status, string failure_identifier) {
+        sequence_table sequence_t(get_self(), agg_symbol.code().raw());
+        auto sequence_itr = sequence_t.find(seq_id);
+        check(sequence_itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
 
+        for(auto& badge_symbol : badge_symbols) {
+            if(inherited_badge_agg_seq_id(org, agg_symbol, seq_id, badge_symbol) != 0) {
+                insert_record_in_badgestatus(org, agg_symbol, seq_id, badge_symbol, sequence_itr->seq_status, status, failure_identifier);
             }
         }
     }
 
+    // scoped by org. started by actseqai, endseqaa, addbadgeai and addbadgeaa,
+    // continued by runjob until next_unit reaches total_units.
+    struct [[eosio::table]] bulkjob {
+        uint64_t job_id;
+        symbol agg_symbol;
+        name job_type;              // addbadge, actseq, endseq
+        vector<uint64_t> seq_ids;
+        vector<symbol> badge_symbols;
+        uint64_t next_unit;
+        uint64_t total_units;       // seq_ids x badge_symbols for addbadge, seq_ids otherwise
+        name status;                // running, done
+        uint64_t primary_key() const { return job_id; }
+    };
+    typedef eosio::multi_index<"bulkjobs"_n, bulkjob> bulkjob_table;
+
+    void activate_sequences(name org, const symbol& agg_symbol, const vector<uint64_t>& seq_ids, string failure_identifier);
+    void end_sequences(name org, const symbol& agg_symbol, const vector<uint64_t>& seq_ids, string failure_identifier);
+    uint64_t start_bulk_job(name org, const symbol& agg_symbol, name job_type, const vector<uint64_t>& seq_ids, const vector<symbol>& badge_symbols, string failure_identifier);
+    void run_bulk_job(name org, uint64_t job_id, uint64_t max_units, string failure_identifier);
+
     struct actseq_args {
         name org;
         symbol agg_symbol;
@@ -385,4 +709,9 @@ private:
       uint8_t actions_used;
     };
 
+    struct billbulk_args {
+      name org;
+      uint64_t actions_used;
+    };
+
 };
@@ -18,7 +18,6 @@ ACTION boundagg::initagg(name org, symbol agg_symbol, vector<symbol> init_badge_
     } else {
         check(false, "Agg already exists");
     }
-
     action {
         permission_level{get_self(), name("active")},
         name(SUBSCRIPTION_CONTRACT),
@@ -98,7 +97,18 @@ ACTION boundagg::initseq(name org, symbol agg_symbol, string sequence_descriptio
         row.init_time = time_point_sec(current_time_point());
         // The active_time and end_time are left uninitialized here and will be set later
     });
-    if(aggdetail_itr->init_badge_symbols.size() > 0) {
+    // migrated orgs record the inherited init_badge_symbols with one id block,
+    // only legacy orgs copy them into badgestatus
+    if(aggdetail_itr->init_badge_symbols.size() > 0 && badgestatus_migrated(org)) {
+        idblock ids = reserve_badge_agg_seq_ids(aggdetail_itr->init_badge_symbols.size());
+        seqinherit_table _seqinherit(get_self(), org.value);
+        _seqinherit.emplace(_self, [&](auto& row) {
+            row.first_badge_agg_seq_id = ids.next_id;
+            row.agg_symbol = agg_symbol;
+            row.seq_id = aggdetail_itr->last_init_seq_id;
+            row.badge_symbols = aggdetail_itr->init_badge_symbols;
+        });
+    } else if(aggdetail_itr->init_badge_symbols.size() > 0) {
         action {
             permission_level{get_self(), name("active")},
             name(get_self()),
@@ -119,43 +129,7 @@ ACTION boundagg::actseq(name org, symbol agg_symbol, vector<uint64_t> seq_ids) {
     if(!has_auth(get_self())) {
         check_internal_auth(name(action_name), failure_identifier);
     }
-
-    // Access the aggdetail table
-    aggdetail_table aggdetail_t(_self, org.value);
-    auto aggdetail_itr = aggdetail_t.find(agg_symbol.code().raw());
-
-    check(aggdetail_itr != aggdetail_t.end(), failure_identifier + "Aggregation symbol does not exist.");
-
-    // Update the last_init_seq_id in aggdetail table
-    aggdetail_t.modify(aggdetail_itr, _self, [&](auto& row) {
-        vector<uint64_t> init_seq_ids = row.init_seq_ids;
-        vector<uint64_t> new_init_seq_ids;
-        vector<uint64_t> new_active_seq_ids = row.active_seq_ids;
-        for (uint64_t seq_id : init_seq_ids) {
-            if (std::find(seq_ids.begin(), seq_ids.end(), seq_id) == seq_ids.end()) {
-                new_init_seq_ids.push_back(seq_id);
-            } else {
-                new_active_seq_ids.push_back(seq_id);
-            }
-        }
-        row.init_seq_ids = new_init_seq_ids;
-        row.active_seq_ids = new_active_seq_ids;
-    });
-    
-    sequence_table sequence_t(get_self(), agg_symbol.code().raw());
-    for (auto& seq_id : seq_ids) {
-        auto itr = sequence_t.find(seq_id);
-        check(itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
-        check(itr->seq_status == "init"_n, failure_identifier + "Sequence is not in init state.");
-
-        sequence_t.modify(itr, _self, [&](auto& row) {
-            row.seq_status = "active"_n;
-            row.active_time = time_point_sec(current_time_point());
-        });
-        update_status_in_badgestatus(org, agg_symbol, seq_id, "active"_n, failure_identifier);
-    }
-
-
+    activate_sequences(org, agg_symbol, seq_ids, failure_identifier);
 }
 
 ACTION boundagg::actseqai(name org, symbol agg_symbol) {
@@ -163,19 +137,8 @@ ACTION boundagg::actseqai(name org, symbol agg_symbol) {
     string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
 
-    vector<uint64_t> init_seq_ids = all_init_seq_ids (org, agg_symbol, failure_identifier);
-
-    action {
-      permission_level{get_self(), name("active")},
-      name(get_self()),
-      name("actseq"),
-      actseq_args {
-        .org = org,
-        .agg_symbol = agg_symbol,
-        .seq_ids = init_seq_ids
-      }
-    }.send();
-
+    vector<uint64_t> seq_ids = all_init_seq_ids (org, agg_symbol, failure_identifier);
+    start_bulk_job(org, agg_symbol, "actseq"_n, seq_ids, {}, failure_identifier);
 }
 
 ACTION boundagg::actseqfi(name org, symbol agg_symbol) {
@@ -205,46 +168,7 @@ ACTION boundagg::endseq(name org, symbol agg_symbol, vector<uint64_t> seq_ids) {
     if(!has_auth(get_self())) {
         check_internal_auth(name(action_name), failure_identifier);
     }
-
-    // Access the aggdetail table
-    aggdetail_table aggdetail_t(_self, org.value);
-    auto aggdetail_itr = aggdetail_t.find(agg_symbol.code().raw());
-
-    check(aggdetail_itr != aggdetail_t.end(), failure_identifier + "Aggregation symbol does not exist.");
-
-
-    aggdetail_t.modify(aggdetail_itr, _self, [&](auto& row) {
-        vector<uint64_t> active_seq_ids = row.active_seq_ids;
-        vector<uint64_t> new_active_seq_ids;
-        vector<uint64_t> end_seq_ids = row.end_seq_ids;
-        
-
-
-        for (uint64_t seq_id : active_seq_ids) {
-            if (std::find(seq_ids.begin(), seq_ids.end(), seq_id) == seq_ids.end()) {
-                new_active_seq_ids.push_back(seq_id);
-            } else {
-                end_seq_ids.push_back(seq_id);
-            }
-        }
-        row.active_seq_ids = new_active_seq_ids;
-        row.end_seq_ids = end_seq_ids;
-    });
-    
-    sequence_table sequence_t(get_self(), agg_symbol.code().raw());
-    for (auto& seq_id : seq_ids) {
-        auto itr = sequence_t.find(seq_id);
-        check(itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
-        check(itr->seq_status == "active"_n, failure_identifier + "Sequence is not in active state.");
-
-        sequence_t.modify(itr, _self, [&](auto& row) {
-            row.seq_status = "end"_n;
-            row.end_time = time_point_sec(current_time_point());
-        });
-
-        update_status_in_badgestatus(org, agg_symbol, seq_id, "end"_n, failure_identifier);
-    }
-
+    end_sequences(org, agg_symbol, seq_ids, failure_identifier);
 }
 
 ACTION boundagg::endseqaa(name org, symbol agg_symbol) {
@@ -252,18 +176,8 @@ ACTION boundagg::endseqaa(name org, symbol agg_symbol) {
     string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
 
-    vector<uint64_t> active_seq_ids = all_active_seq_ids (org, agg_symbol, failure_identifier);
-
-    action {
-      permission_level{get_self(), name("active")},
-      name(get_self()),
-      name("endseq"),
-      endseq_args {
-        .org = org,
-        .agg_symbol = agg_symbol,
-        .seq_ids = active_seq_ids
-      }
-    }.send();
+    vector<uint64_t> seq_ids = all_active_seq_ids (org, agg_symbol, failure_identifier);
+    start_bulk_job(org, agg_symbol, "endseq"_n, seq_ids, {}, failure_identifier);
 }
 
 ACTION boundagg::endseqfa(name org, symbol agg_symbol) {
@@ -294,22 +208,23 @@ ACTION boundagg::addbadge(name org, symbol agg_symbol, vector<uint64_t> seq_ids,
         check_internal_auth(name(action_name), failure_identifier);
     }
 
-    uint8_t actions_used = 0;
+    uint64_t actions_used = 0;
+    idblock ids = reserve_badge_agg_seq_ids(seq_ids.size() * badge_symbols.size());
     sequence_table sequence_t(get_self(), agg_symbol.code().raw());
     for (const auto& seq_id : seq_ids) {
         auto itr = sequence_t.find(seq_id);
         check(itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
         for (const auto& badge_symbol : badge_symbols) {
             actions_used++;
-            insert_record_in_badgestatus(org, agg_symbol, seq_id, badge_symbol, itr->seq_status, failure_identifier);
+            insert_record_in_badgestatus(org, agg_symbol, seq_id, badge_symbol, itr->seq_status, "active"_n, failure_identifier, &ids);
         }
     }
     if(actions_used > 0) {
         action {
             permission_level{get_self(), name("active")},
             name(SUBSCRIPTION_CONTRACT),
-            name("billing"),
-            billing_args {
+            name("billbulk"),
+            billbulk_args {
                 .org = org,
                 .actions_used = actions_used}
         }.send();    
@@ -341,18 +256,9 @@ ACTION boundagg::addbadgeaa(name org, symbol agg_symbol, vector<symbol> badge_sy
     string action_name = "addbadgeaa";
     string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
-    vector<uint64_t> active_seq_ids = all_active_seq_ids (org, agg_symbol, failure_identifier);
-    action {
-      permission_level{get_self(), name("active")},
-      name(get_self()),
-      name("addbadge"),
-      addbadge_args {
-        .org = org,
-        .agg_symbol = agg_symbol,
-        .seq_ids = active_seq_ids,
-        .badge_symbols = badge_symbols
-      }
-    }.send(); 
+
+    vector<uint64_t> seq_ids = all_active_seq_ids (org, agg_symbol, failure_identifier);
+    start_bulk_job(org, agg_symbol, "addbadge"_n, seq_ids, badge_symbols, failure_identifier);
 }
 
 ACTION boundagg::addbadgefi(name org, symbol agg_symbol, vector<symbol> badge_symbols) {
@@ -401,50 +307,22 @@ ACTION boundagg::addbadgeai(name org, symbol agg_symbol, vector<symbol> badge_sy
     string action_name = "addbadgeai";
     string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
-    vector<uint64_t> init_seq_ids = all_init_seq_ids (org, agg_symbol, failure_identifier);
-    action {
-      permission_level{get_self(), name("active")},
-      name(get_self()),
-      name("addbadge"),
-      addbadge_args {
-        .org = org,
-        .agg_symbol = agg_symbol,
-        .seq_ids = init_seq_ids,
-        .badge_symbols = badge_symbols
-      }
-    }.send(); 
 
+    vector<uint64_t> seq_ids = all_init_seq_ids (org, agg_symbol, failure_identifier);
+    start_bulk_job(org, agg_symbol, "addbadge"_n, seq_ids, badge_symbols, failure_identifier);
 }
 
 void boundagg::notifyachiev(name org, asset badge_asset, name from, name to, string memo, vector<name> notify_accounts) {
     string action_name = "notifyachiev";
     string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
 
-    badgestatus_table badgestatus(get_self(), org.value);
-    auto by_status_index = badgestatus.get_index<"bybadgestat"_n>();
-
-    auto hashed_active_status = hash_active_status(badge_asset.symbol, "active"_n, "active"_n);
+    vector<uint64_t> badge_agg_seq_ids = active_badge_agg_seq_ids(org, badge_asset.symbol);
     achievements_table achievements(get_self(), to.value);
 
-    auto itr = by_status_index.find(hashed_active_status);
     uint8_t actions_used = 0;
-    while(itr != by_status_index.end() && itr->badge_symbol == badge_asset.symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
-        
-        auto ach_itr = achievements.find(itr->badge_agg_seq_id);
-        if(ach_itr != achievements.end()) {
-            achievements.modify(ach_itr, get_self(), [&](auto& ach) {
-                ach.count += badge_asset.amount;
-            });
-        } else {
-            achievements.emplace(get_self(), [&](auto& ach) {
-                ach.badge_agg_seq_id = itr->badge_agg_seq_id;
-                ach.count = badge_asset.amount;
-            });
-        }
-        
-        // Move to the next record
+    for(auto badge_agg_seq_id : badge_agg_seq_ids) {
+        add_achievement(achievements, badge_agg_seq_id, badge_asset.amount);
         actions_used ++;
-        ++itr;
     }
     if(actions_used > 0) {
         action {
@@ -459,6 +337,64 @@ void boundagg::notifyachiev(name org, asset badge_asset, name from, name to, str
 
 }
 
+void boundagg::notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash) {
+    if (notify_account != get_self()) {
+        return;
+    }
+    // v2 events carry neither memo nor notify_accounts, neither is used here
+    notifyachiev(org, asset(amount, badge_symbol), from, to, "", {});
+}
+
+void boundagg::notifybatch(name org, name notify_account, vector<achievement_event> events) {
+    if(notify_account != get_self()) {
+        return;
+    }
+
+    // active ids are resolved once per badge, achievements once per recipient
+    std::map<symbol, vector<uint64_t>> badge_agg_seq_ids;
+    std::map<name, std::map<symbol, uint64_t>> recipient_totals;
+    uint64_t actions_used = 0;
+    for(auto& event : events) {
+        auto ids_itr = badge_agg_seq_ids.find(event.badge_asset.symbol);
+        if(ids_itr == badge_agg_seq_ids.end()) {
+            ids_itr = badge_agg_seq_ids.emplace(event.badge_asset.symbol, active_badge_agg_seq_ids(org, event.badge_asset.symbol)).first;
+        }
+        if(ids_itr->second.empty()) {
+            continue;
+        }
+        recipient_totals[event.to][event.badge_asset.symbol] += event.badge_asset.amount;
+        actions_used += ids_itr->second.size();
+    }
+
+    for(auto& [to, totals] : recipient_totals) {
+        achievements_table achievements(get_self(), to.value);
+        for(auto& [badge_symbol, amount] : totals) {
+            for(auto badge_agg_seq_id : badge_agg_seq_ids[badge_symbol]) {
+                add_achievement(achievements, badge_agg_seq_id, amount);
+            }
+        }
+    }
+
+    if(actions_used > 0) {
+        action {
+            permission_level{get_self(), name("active")},
+            name(SUBSCRIPTION_CONTRACT),
+            name("billbulk"),
+            billbulk_args {
+                .org = org,
+                .actions_used = actions_used}
+        }.send();
+    }
+}
+
 
     ACTION boundagg::pauseall(name org, symbol agg_symbol, uint64_t seq_id) {
         string action_name = "pauseall";
@@ -524,3 +460,221 @@ void boundagg::notifyachiev(name org, asset badge_asset, name from, name to, str
     }
 
 
+
+    // re-emplaces badgestatus rows of org in primary key order so their secondary keys are rebuilt
+    // from the packed raw values, and seeds activeroutes. resumable, each call moves at most max_rows rows.
+    // once done the org runs on the normalized model: sequence status is read from aggdetail and
+    // new sequences inherit init_badge_symbols through a seqinherits row instead of badgestatus rows.
+    ACTION boundagg::migratebs(name org, uint16_t max_rows) {
+        string action_name = "migratebs";
+        string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
+        check_internal_auth(name(action_name), failure_identifier);
+
+        bsmigration_table _bsmigration(get_self(), get_self().value);
+        auto bsmigration_itr = _bsmigration.find(org.value);
+        check(bsmigration_itr == _bsmigration.end() || !bsmigration_itr->done, failure_identifier + "badgestatus already migrated for org");
+        uint64_t last_badge_agg_seq_id = (bsmigration_itr == _bsmigration.end()) ? 0 : bsmigration_itr->last_badge_agg_seq_id;
+
+        badgestatus_table badgestatus_t(get_self(), org.value);
+        auto itr = badgestatus_t.upper_bound(last_badge_agg_seq_id);
+        for(uint16_t i = 0; i < max_rows && itr != badgestatus_t.end(); i++) {
+            badgestatus row = *itr;
+            badgestatus_t.erase(itr);
+            badgestatus_t.emplace(get_self(), [&](auto& entry) {
+                entry = row;
+            });
+            set_active_route(org, row.badge_symbol, {row.badge_agg_seq_id, row.agg_symbol, row.seq_id}, row.badge_status == "active"_n && row.seq_status == "active"_n);
+            last_badge_agg_seq_id = row.badge_agg_seq_id;
+            itr = badgestatus_t.upper_bound(last_badge_agg_seq_id);
+        }
+        bool done = itr == badgestatus_t.end();
+
+        if(bsmigration_itr == _bsmigration.end()) {
+            _bsmigration.emplace(get_self(), [&](auto& entry) {
+                entry.org = org;
+                entry.last_badge_agg_seq_id = last_badge_agg_seq_id;
+                entry.done = done;
+            });
+        } else {
+            _bsmigration.modify(bsmigration_itr, get_self(), [&](auto& entry) {
+                entry.last_badge_agg_seq_id = last_badge_agg_seq_id;
+                entry.done = done;
+            });
+        }
+    }
+
+    ACTION boundagg::runjob(name org, uint64_t job_id, uint16_t max_units) {
+        string action_name = "runjob";
+        string failure_identifier = "CONTRACT: boundagg, ACTION: " + action_name + ", MESSAGE: ";
+        run_bulk_job(org, job_id, max_units, failure_identifier);
+    }
+
+void boundagg::activate_sequences(name org, const symbol& agg_symbol, const vector<uint64_t>& seq_ids, string failure_identifier) {
+    // Access the aggdetail table
+    aggdetail_table aggdetail_t(_self, org.value);
+    auto aggdetail_itr = aggdetail_t.find(agg_symbol.code().raw());
+
+    check(aggdetail_itr != aggdetail_t.end(), failure_identifier + "Aggregation symbol does not exist.");
+
+    // Update the last_init_seq_id in aggdetail table
+    aggdetail_t.modify(aggdetail_itr, _self, [&](auto& row) {
+        vector<uint64_t> init_seq_ids = row.init_seq_ids;
+        vector<uint64_t> new_init_seq_ids;
+        vector<uint64_t> new_active_seq_ids = row.active_seq_ids;
+        for (uint64_t seq_id : init_seq_ids) {
+            if (std::find(seq_ids.begin(), seq_ids.end(), seq_id) == seq_ids.end()) {
+                new_init_seq_ids.push_back(seq_id);
+            } else {
+                new_active_seq_ids.push_back(seq_id);
+            }
+        }
+        row.init_seq_ids = new_init_seq_ids;
+        row.active_seq_ids = new_active_seq_ids;
+    });
+    
+    bool migrated = badgestatus_migrated(org);
+    sequence_table sequence_t(get_self(), agg_symbol.code().raw());
+    for (auto& seq_id : seq_ids) {
+        auto itr = sequence_t.find(seq_id);
+        check(itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
+        check(itr->seq_status == "init"_n, failure_identifier + "Sequence is not in init state.");
+
+        sequence_t.modify(itr, _self, [&](auto& row) {
+            row.seq_status = "active"_n;
+            row.active_time = time_point_sec(current_time_point());
+        });
+        if(!migrated) {
+            update_status_in_badgestatus(org, agg_symbol, seq_id, "active"_n, failure_identifier);
+        }
+        route_sequence(org, agg_symbol, seq_id, true);
+    }
+
+
+}
+
+void boundagg::end_sequences(name org, const symbol& agg_symbol, const vector<uint64_t>& seq_ids, string failure_identifier) {
+    // Access the aggdetail table
+    aggdetail_table aggdetail_t(_self, org.value);
+    auto aggdetail_itr = aggdetail_t.find(agg_symbol.code().raw());
+
+    check(aggdetail_itr != aggdetail_t.end(), failure_identifier + "Aggregation symbol does not exist.");
+
+
+    aggdetail_t.modify(aggdetail_itr, _self, [&](auto& row) {
+        vector<uint64_t> active_seq_ids = row.active_seq_ids;
+        vector<uint64_t> new_active_seq_ids;
+        vector<uint64_t> end_seq_ids = row.end_seq_ids;
+        
+
+
+        for (uint64_t seq_id : active_seq_ids) {
+            if (std::find(seq_ids.begin(), seq_ids.end(), seq_id) == seq_ids.end()) {
+                new_active_seq_ids.push_back(seq_id);
+            } else {
+                end_seq_ids.push_back(seq_id);
+            }
+        }
+        row.active_seq_ids = new_active_seq_ids;
+        row.end_seq_ids = end_seq_ids;
+    });
+    
+    bool migrated = badgestatus_migrated(org);
+    sequence_table sequence_t(get_self(), agg_symbol.code().raw());
+    for (auto& seq_id : seq_ids) {
+        auto itr = sequence_t.find(seq_id);
+        check(itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
+        check(itr->seq_status == "active"_n, failure_identifier + "Sequence is not in active state.");
+
+        sequence_t.modify(itr, _self, [&](auto& row) {
+            row.seq_status = "end"_n;
+            row.end_time = time_point_sec(current_time_point());
+        });
+
+        if(!migrated) {
+            update_status_in_badgestatus(org, agg_symbol, seq_id, "end"_n, failure_identifier);
+        }
+        route_sequence(org, agg_symbol, seq_id, false);
+    }
+
+}
+
+uint64_t boundagg::start_bulk_job(name org, const symbol& agg_symbol, name job_type, const vector<uint64_t>& seq_ids, const vector<symbol>& badge_symbols, string failure_identifier) {
+    uint64_t total_units = (job_type == "addbadge"_n) ? seq_ids.size() * badge_symbols.size() : seq_ids.size();
+    check(total_units > 0, failure_identifier + "bulk job has no work");
+
+    bulkjob_table bulkjob_t(get_self(), org.value);
+    uint64_t job_id = bulkjob_t.available_primary_key();
+    bulkjob_t.emplace(get_self(), [&](auto& row) {
+        row.job_id = job_id;
+        row.agg_symbol = agg_symbol;
+        row.job_type = job_type;
+        row.seq_ids = seq_ids;
+        row.badge_symbols = badge_symbols;
+        row.next_unit = 0;
+        row.total_units = total_units;
+        row.status = "running"_n;
+    });
+
+    run_bulk_job(org, job_id, BULK_CHUNK_UNITS, failure_identifier);
+    return job_id;
+}
+
+void boundagg::run_bulk_job(name org, uint64_t job_id, uint64_t max_units, string failure_identifier) {
+    bulkjob_table bulkjob_t(get_self(), org.value);
+    auto job_itr = bulkjob_t.find(job_id);
+    check(job_itr != bulkjob_t.end(), failure_identifier + "bulk job does not exist");
+    check(job_itr->status == "running"_n, failure_identifier + "bulk job is not running");
+
+    uint64_t unit = job_itr->next_unit;
+    uint64_t end_unit = std::min(job_itr->total_units, unit + max_units);
+    uint64_t actions_used = 0;
+    sequence_table sequence_t(get_self(), job_itr->agg_symbol.code().raw());
+
+    if(job_itr->job_type == "addbadge"_n) {
+        // unit u is (seq_ids[u / badges], badge_symbols[u % badges])
+        uint64_t badge_count = job_itr->badge_symbols.size();
+        idblock ids = reserve_badge_agg_seq_ids(end_unit - unit);
+        for(; unit < end_unit; unit++) {
+            uint64_t seq_id = job_itr->seq_ids[unit / badge_count];
+            auto sequence_itr = sequence_t.find(seq_id);
+            check(sequence_itr != sequence_t.end(), failure_identifier + "Sequence ID does not exist.");
+            insert_record_in_badgestatus(org, job_itr->agg_symbol, seq_id, job_itr->badge_symbols[unit % badge_count], sequence_itr->seq_status, "active"_n, failure_identifier, &ids);
+            actions_used++;
+        }
+    } else {
+        // sequences that changed state since the job started are skipped so the job cannot get stuck
+        name expected_status = (job_itr->job_type == "actseq"_n) ? "init"_n : "active"_n;
+        vector<uint64_t> seq_ids;
+        for(; unit < end_unit; unit++) {
+            auto sequence_itr = sequence_t.find(job_itr->seq_ids[unit]);
+            if(sequence_itr != sequence_t.end() && sequence_itr->seq_status == expected_status) {
+                seq_ids.push_back(sequence_itr->seq_id);
+            }
+        }
+        if(!seq_ids.empty()) {
+            if(job_itr->job_type == "actseq"_n) {
+                activate_sequences(org, job_itr->agg_symbol, seq_ids, failure_identifier);
+            } else {
+                end_sequences(org, job_itr->agg_symbol, seq_ids, failure_identifier);
+            }
+        }
+    }
+
+    bulkjob_t.modify(job_itr, get_self(), [&](auto& row) {
+        row.next_unit = unit;
+        if(unit == row.total_units) {
+            row.status = "done"_n;
+        }
+    });
+
+    if(actions_used > 0) {
+        action {
+            permission_level{get_self(), name("active")},
+            name(SUBSCRIPTION_CONTRACT),
+            name("billbulk"),
+            billbulk_args {
+                .org = org,
+                .actions_used = actions_used}
+        }.send();
+    }
+}
@@ -2,6 +2,8 @@
 #include <eosio/asset.hpp>
 #include <hyperloglog.hpp>
 #include <eosio/crypto.hpp>
+#include <optional>
+#include <eventlog.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -12,6 +14,7 @@ using namespace eosio;
 #define BOUNDED_AGG_CONTRACT "baggyyyyyyyy"
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
 
+
 CONTRACT boundedhll : public contract {
 public:
     using contract::contract;
@@ -37,7 +40,20 @@ public:
     ACTION activate(name org, symbol agg_symbol, symbol badge_symbol);
 
     ACTION deactivate(name org, symbol agg_symbol, symbol badge_symbol);
+
+    ACTION crank(name org, uint16_t max_events);
+
+    // estimated unique senders to account over the given sequences of any badge
+    [[eosio::action, eosio::read_only]]
+    uint64_t unionseqs(name org, name account, vector<uint64_t> badge_agg_seq_ids);
+
+    // estimated unique senders to account over every sequence and badge of agg_symbol
+    [[eosio::action, eosio::read_only]]
+    uint64_t unionagg(name org, symbol agg_symbol, name account);
 private:
+    // 2^7 registers per sender hll, stored sparse until promoted to 6-bit packed
+    typedef hll::PackedHyperLogLog<7> sender_hll;
+
     // scoped by agg_symbol
     TABLE emissions {
         symbol badge_symbol;
@@ -47,7 +63,9 @@ private:
     };
     typedef multi_index<name("emissions"), emissions> emissions_table;
 
-    // scoped by account
+    // scoped by account, sender hll of a sequence that is no longer active for its badge.
+    // badgehlls moves such sequences here on its next write and folds a row back in
+    // if its sequence is updated again, rows from before badgehlls are folded the same way.
     TABLE balances {
         uint64_t badge_agg_seq_id; // Badge name
         vector<uint8_t> hll;       // HyperLogLog data or any other binary data
@@ -55,6 +73,37 @@ private:
     };
     typedef multi_index<"balances"_n, balances> balances_table;
 
+    struct seqhll {
+        uint64_t badge_agg_seq_id;
+        vector<uint8_t> hll;
+    };
+
+    // scoped by account, sender hll of the active sequences the badge was received in,
+    // so the row does not grow with ended sequences
+    TABLE badgehll {
+        symbol badge_symbol;
+        vector<seqhll> seq_hlls;   // sorted by badge_agg_seq_id
+        auto primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<"badgehlls"_n, badgehll> badgehll_table;
+
+    template <typename SeqHlls>
+    static auto find_seq_hll(SeqHlls& seq_hlls, uint64_t badge_agg_seq_id) {
+        auto itr = std::lower_bound(seq_hlls.begin(), seq_hlls.end(), badge_agg_seq_id,
+            [](const seqhll& entry, uint64_t id) { return entry.badge_agg_seq_id < id; });
+        return (itr != seq_hlls.end() && itr->badge_agg_seq_id == badge_agg_seq_id) ? itr : seq_hlls.end();
+    }
+
+    // registers of badge_agg_seq_id, inserted empty in order when missing
+    static vector<uint8_t>& seq_hll_registers(vector<seqhll>& seq_hlls, uint64_t badge_agg_seq_id) {
+        auto itr = std::lower_bound(seq_hlls.begin(), seq_hlls.end(), badge_agg_seq_id,
+            [](const seqhll& entry, uint64_t id) { return entry.badge_agg_seq_id < id; });
+        if(itr == seq_hlls.end() || itr->badge_agg_seq_id != badge_agg_seq_id) {
+            itr = seq_hlls.insert(itr, seqhll{badge_agg_seq_id, {}});
+        }
+        return itr->hll;
+    }
+
     // scoped by org.
     TABLE badgestatus {
         uint64_t badge_agg_seq_id;  // Primary key: Unique ID for each badge-sequence association
@@ -66,13 +115,16 @@ private:
 
         uint64_t primary_key() const { return badge_agg_seq_id; }
         uint128_t by_agg_seq() const { return combine_keys(agg_symbol.code().raw(), seq_id); }
-        checksum256 by_badge_status() const {
-            auto data = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
-            return sha256(data.data(), data.size());
+        // secondary keys pack the raw values into the words of a checksum256, nothing is hashed
+        checksum256 by_badge_status() const { return badge_status_key(badge_symbol, badge_status, seq_status); }
+        checksum256 by_agg_seq_badge() const { return agg_seq_badge_key(agg_symbol, seq_id, badge_symbol); }
+
+        static checksum256 badge_status_key(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
+            return checksum256::make_from_word_sequence<uint64_t>(badge_symbol.code().raw(), badge_status.value, seq_status.value, uint64_t(0));
         }
-        checksum256 by_agg_seq_badge() const {
-            auto data = agg_symbol.code().to_string() + std::to_string(seq_id) + badge_symbol.code().to_string();
-            return sha256(data.data(), data.size());
+
+        static checksum256 agg_seq_badge_key(const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+            return checksum256::make_from_word_sequence<uint64_t>(agg_symbol.code().raw(), seq_id, badge_symbol.code().raw(), uint64_t(0));
         }
 
         static uint128_t combine_keys(uint64_t a, uint64_t b) {
@@ -85,6 +137,86 @@ private:
         indexed_by<"aggseqbadge"_n, const_mem_fun<badgestatus, checksum256, &badgestatus::by_agg_seq_badge>>
     > badgestatus_table;
 
+    // scoped by boundagg contract, rows past last_badge_agg_seq_id still carry the legacy sha256 keys until done
+    TABLE bsmigration {
+        name org;
+        uint64_t last_badge_agg_seq_id;
+        bool done;
+        auto primary_key() const { return org.value; }
+    };
+    typedef multi_index<name("bsmigration"), bsmigration> bsmigration_table;
+
+    bool badgestatus_migrated(name org) {
+        bsmigration_table _bsmigration(name(BOUNDED_AGG_CONTRACT), name(BOUNDED_AGG_CONTRACT).value);
+        auto bsmigration_itr = _bsmigration.find(org.value);
+        return bsmigration_itr != _bsmigration.end() && bsmigration_itr->done;
+    }
+
+    struct routeentry {
+        uint64_t badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+    };
+
+    // scoped by org, see boundagg::activeroute
+    TABLE activeroute {
+        symbol badge_symbol;
+        vector<routeentry> routes;
+        auto primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<name("activeroutes"), activeroute> activeroute_table;
+
+    // scoped by org, init badges a sequence of a migrated org inherits, see boundagg::seqinherit
+    TABLE seqinherit {
+        uint64_t first_badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+        vector<symbol> badge_symbols;
+        uint64_t primary_key() const { return first_badge_agg_seq_id; }
+        uint128_t by_agg_seq() const { return badgestatus::combine_keys(agg_symbol.code().raw(), seq_id); }
+    };
+    typedef multi_index<name("seqinherits"), seqinherit,
+        indexed_by<"byaggseq"_n, const_mem_fun<seqinherit, uint128_t, &seqinherit::by_agg_seq>>
+    > seqinherit_table;
+
+    // the seqinherit row whose id block holds badge_agg_seq_id, end() if there is none
+    seqinherit_table::const_iterator find_inherit_block(seqinherit_table& _seqinherit, uint64_t badge_agg_seq_id) {
+        auto itr = _seqinherit.upper_bound(badge_agg_seq_id);
+        if(itr == _seqinherit.begin()) {
+            return _seqinherit.end();
+        }
+        itr--;
+        if(badge_agg_seq_id - itr->first_badge_agg_seq_id >= itr->badge_symbols.size()) {
+            return _seqinherit.end();
+        }
+        return itr;
+    }
+
+    // active (badge, sequence) pairs of badge_symbol, see boundagg::active_routes
+    vector<routeentry> active_routes(name org, const symbol& badge_symbol) {
+        if(badgestatus_migrated(org)) {
+            activeroute_table _activeroute(name(BOUNDED_AGG_CONTRACT), org.value);
+            auto activeroute_itr = _activeroute.find(badge_symbol.code().raw());
+            return activeroute_itr == _activeroute.end() ? vector<routeentry>() : activeroute_itr->routes;
+        }
+
+        vector<routeentry> routes;
+        badgestatus_table badgestatus_t(name(BOUNDED_AGG_CONTRACT), org.value);
+        auto by_status_index = badgestatus_t.get_index<"bybadgestat"_n>();
+        vector<checksum256> keys = {
+            badgestatus::badge_status_key(badge_symbol, "active"_n, "active"_n),
+            hash_active_status(badge_symbol, "active"_n, "active"_n)};
+        for(auto& key : keys) {
+            auto itr = by_status_index.find(key);
+            while(itr != by_status_index.end() && itr->badge_symbol == badge_symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
+                routes.push_back({itr->badge_agg_seq_id, itr->agg_symbol, itr->seq_id});
+                itr++;
+            }
+        }
+        return routes;
+    }
+
+    // legacy sha256 keys, only used for rows not yet re-indexed by boundagg::migratebs
     checksum256 hash_active_status(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
         string data_str = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
         return sha256(data_str.data(), data_str.size());
@@ -114,6 +246,14 @@ private:
         check(false, failure_identifier + "Calling contract not in authorized list of accounts for action " + action.to_string());
     }
 
+    // updates the sender hll of every active sequence of badge_symbol in one write of
+    // the account's badge row and issues the uniqueness badges of sequences whose registers change
+    void record_sender(name org, const symbol& badge_symbol, name from, name to);
+
+    // merges the sender hlls account holds for badge_agg_seq_ids and estimates the union,
+    // ids without a balances row contribute nothing
+    uint64_t union_estimate(name org, name account, const vector<uint64_t>& badge_agg_seq_ids);
+
     struct issue_args {
         name org;
         asset badge_asset;
@@ -8,76 +8,205 @@ void boundedhll::notifyachiev (
     string memo,
     vector<name> notify_accounts
 ) {
-    string action_name = "notifyachiev";
-    string failure_identifier = "CONTRACT: boundedhll, ACTION: " + action_name + ", MESSAGE: ";
-    badgestatus_table badgestatus(name(BOUNDED_AGG_CONTRACT), org.value);
-    auto badge_status_index = badgestatus.get_index<"bybadgestat"_n>();
-    auto hashed_active_status = hash_active_status(badge_asset.symbol, "active"_n, "active"_n);
-    auto itr = badge_status_index.find(hashed_active_status);
+    record_sender(org, badge_asset.symbol, from, to);
+}
+
+ACTION boundedhll::crank(name org, uint16_t max_events) {
+    uint64_t head_log_seq = 0;
+    eventlog_reader event_log(get_self(), name(ORCHESTRATOR_CONTRACT));
+    vector<eventlog> events = event_log.drain(org, max_events, head_log_seq);
+
+    std::map<uint64_t, bool> followed_badges;
+    for(auto& event : events) {
+        if(event_log.follows_badge(org, event.badge_symbol, followed_badges)) {
+            record_sender(org, event.badge_symbol, event.from, event.to);
+        }
+    }
+}
 
-    while(itr != badge_status_index.end() && itr->badge_symbol == badge_asset.symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
-        emissions_table emissions(_self, itr->agg_symbol.code().raw());
-        auto emissions_itr = emissions.find(itr->badge_symbol.code().raw());
+void boundedhll::record_sender(name org, const symbol& badge_symbol, name from, name to) {
+    vector<routeentry> routes = active_routes(org, badge_symbol);
+
+    // the badge has one emission per agg, shared by the active sequences of that agg
+    std::map<uint64_t, std::optional<vector<symbol>>> active_emissions;
+    vector<routeentry> emitting_routes;
+    for(auto& route : routes) {
+        uint64_t agg_code = route.agg_symbol.code().raw();
+        auto active_emissions_itr = active_emissions.find(agg_code);
+        if(active_emissions_itr == active_emissions.end()) {
+            emissions_table emissions(_self, agg_code);
+            auto emissions_itr = emissions.find(badge_symbol.code().raw());
+            std::optional<vector<symbol>> sender_uniqueness_badge_symbols;
+            if(emissions_itr != emissions.end() && emissions_itr->status == name("active")) {
+                sender_uniqueness_badge_symbols = emissions_itr->sender_uniqueness_badge_symbols;
+            }
+            active_emissions_itr = active_emissions.emplace(agg_code, sender_uniqueness_badge_symbols).first;
+        }
+        if(active_emissions_itr->second) {
+            emitting_routes.push_back(route);
+        }
+    }
+    if(emitting_routes.empty()) {
+        return;
+    }
 
-        if(emissions_itr != emissions.end() && emissions_itr->status == name("active")) {
-            balances_table _balances(_self, to.value);
-            auto balances_itr = _balances.find(itr->badge_agg_seq_id);
+    sender_hll::element sender(from.value);
 
-            uint8_t b = 7;
-            uint32_t m = 1 << b;
+    badgehll_table _badgehll(_self, to.value);
+    balances_table _balances(_self, to.value);
+    auto badgehll_itr = _badgehll.find(badge_symbol.code().raw());
 
-            if (balances_itr == _balances.end()) {
-                vector<uint8_t> M(m, 0);
-                hll::HyperLogLog hll(b, m, M);
-                hll.add(from.to_string().c_str(), from.to_string().size());
+    // decide on the stored row first, a sender already seen in every sequence costs no write
+    vector<bool> raised(emitting_routes.size(), false);
+    vector<uint64_t> legacy_ids;
+    bool write = false;
+    for(size_t i = 0; i < emitting_routes.size(); i++) {
+        uint64_t badge_agg_seq_id = emitting_routes[i].badge_agg_seq_id;
+        if(badgehll_itr != _badgehll.end()) {
+            auto seq_hll_itr = find_seq_hll(badgehll_itr->seq_hlls, badge_agg_seq_id);
+            if(seq_hll_itr != badgehll_itr->seq_hlls.end()) {
+                raised[i] = sender_hll::raises(seq_hll_itr->hll, sender);
+                write = write || raised[i];
+                continue;
+            }
+        }
+        // sequence not in the badge row yet, its registers may still be in a per sequence balances row
+        auto balances_itr = _balances.find(badge_agg_seq_id);
+        if(balances_itr != _balances.end()) {
+            legacy_ids.push_back(badge_agg_seq_id);
+            raised[i] = sender_hll::raises(balances_itr->hll, sender);
+        } else {
+            raised[i] = true;
+        }
+        write = true;
+    }
 
+    auto update_seq_hlls = [&](vector<seqhll>& seq_hlls) {
+        for(size_t i = 0; i < emitting_routes.size(); i++) {
+            uint64_t badge_agg_seq_id = emitting_routes[i].badge_agg_seq_id;
+            vector<uint8_t>& registers = seq_hll_registers(seq_hlls, badge_agg_seq_id);
+            if(registers.empty()) {
+                auto balances_itr = _balances.find(badge_agg_seq_id);
+                if(balances_itr != _balances.end()) {
+                    registers = balances_itr->hll;
+                }
+            }
+            if(raised[i]) {
+                sender_hll(registers).add(sender);
+            }
+        }
+    };
+    if(badgehll_itr == _badgehll.end()) {
+        _badgehll.emplace(get_self(), [&](auto& row) {
+            row.badge_symbol = badge_symbol;
+            update_seq_hlls(row.seq_hlls);
+        });
+    } else if(write) {
+        // sequences no longer active for the badge move to their own balances row, unions still read them there
+        auto inactive = [&](const seqhll& entry) {
+            return std::none_of(routes.begin(), routes.end(), [&](const routeentry& route) {
+                return route.badge_agg_seq_id == entry.badge_agg_seq_id;
+            });
+        };
+        for(auto& entry : badgehll_itr->seq_hlls) {
+            if(inactive(entry)) {
                 _balances.emplace(get_self(), [&](auto& row) {
-                    row.badge_agg_seq_id = itr->badge_agg_seq_id;
-                    row.hll = hll.registers();
+                    row.badge_agg_seq_id = entry.badge_agg_seq_id;
+                    row.hll = entry.hll;
                 });
+            }
+        }
+        _badgehll.modify(badgehll_itr, get_self(), [&](auto& row) {
+            row.seq_hlls.erase(std::remove_if(row.seq_hlls.begin(), row.seq_hlls.end(), inactive), row.seq_hlls.end());
+            update_seq_hlls(row.seq_hlls);
+        });
+    }
+    for(auto badge_agg_seq_id : legacy_ids) {
+        _balances.erase(_balances.find(badge_agg_seq_id));
+    }
 
-                for(auto i = 0 ; i < emissions_itr->sender_uniqueness_badge_symbols.size(); i++) {
-                    action {
-                        permission_level{get_self(), name("active")},
-                        name(name(SIMPLEBADGE_CONTRACT)),
-                        name("issue"),
-                        issue_args {
-                            .org = org,
-                            .badge_asset = eosio::asset(1, emissions_itr->sender_uniqueness_badge_symbols[i]),
-                            .to = to,
-                            .memo = "issued from rollup consumer"
-                        }
-                    }.send();
-                }
-            } else {
-                vector<uint8_t> M = balances_itr->hll;
-                hll::HyperLogLog hll(b, m, M);
-                double estimate_before = hll.estimate();
-                hll.add(from.to_string().c_str(), from.to_string().size());
-                double estimate_after = hll.estimate();
-
-                if (estimate_before != estimate_after) {
-                    _balances.modify(balances_itr, get_self(), [&](auto& row) {
-                        row.hll = hll.registers();
-                    });
-                    for(auto i = 0 ; i < emissions_itr->sender_uniqueness_badge_symbols.size(); i++) {
-                        action {
-                            permission_level{get_self(), name("active")},
-                            name(name(SIMPLEBADGE_CONTRACT)),
-                            name("issue"),
-                            issue_args {
-                                .org = org,
-                                .badge_asset = eosio::asset(1, emissions_itr->sender_uniqueness_badge_symbols[i]),
-                                .to = to,
-                                .memo = "issued from rollup consumer"
-                            }
-                        }.send();
-                    }
+    for(size_t i = 0; i < emitting_routes.size(); i++) {
+        if(!raised[i]) {
+            continue;
+        }
+        auto& sender_uniqueness_badge_symbols = *active_emissions[emitting_routes[i].agg_symbol.code().raw()];
+        for(auto& sender_uniqueness_badge_symbol : sender_uniqueness_badge_symbols) {
+            action {
+                permission_level{get_self(), name("active")},
+                name(name(SIMPLEBADGE_CONTRACT)),
+                name("issue"),
+                issue_args {
+                    .org = org,
+                    .badge_asset = eosio::asset(1, sender_uniqueness_badge_symbol),
+                    .to = to,
+                    .memo = "issued from rollup consumer"
                 }
-            }
+            }.send();
         }
+    }
+}
+
+uint64_t boundedhll::unionseqs(name org, name account, vector<uint64_t> badge_agg_seq_ids) {
+    return union_estimate(org, account, badge_agg_seq_ids);
+}
+
+uint64_t boundedhll::unionagg(name org, symbol agg_symbol, name account) {
+    badgestatus_table badgestatus_t(name(BOUNDED_AGG_CONTRACT), org.value);
+    auto by_agg_seq_index = badgestatus_t.get_index<"byaggseq"_n>();
+    vector<uint64_t> badge_agg_seq_ids;
+    auto itr = by_agg_seq_index.lower_bound(badgestatus::combine_keys(agg_symbol.code().raw(), 0));
+    while(itr != by_agg_seq_index.end() && itr->agg_symbol == agg_symbol) {
+        badge_agg_seq_ids.push_back(itr->badge_agg_seq_id);
         itr++;
     }
+    // inherited badges without a badgestatus row
+    seqinherit_table _seqinherit(name(BOUNDED_AGG_CONTRACT), org.value);
+    auto inherit_index = _seqinherit.get_index<"byaggseq"_n>();
+    auto inherit_itr = inherit_index.lower_bound(badgestatus::combine_keys(agg_symbol.code().raw(), 0));
+    while(inherit_itr != inherit_index.end() && inherit_itr->agg_symbol == agg_symbol) {
+        for(uint64_t i = 0; i < inherit_itr->badge_symbols.size(); i++) {
+            uint64_t badge_agg_seq_id = inherit_itr->first_badge_agg_seq_id + i;
+            if(badgestatus_t.find(badge_agg_seq_id) == badgestatus_t.end()) {
+                badge_agg_seq_ids.push_back(badge_agg_seq_id);
+            }
+        }
+        inherit_itr++;
+    }
+    return union_estimate(org, account, badge_agg_seq_ids);
+}
+
+uint64_t boundedhll::union_estimate(name org, name account, const vector<uint64_t>& badge_agg_seq_ids) {
+    badgestatus_table badgestatus_t(name(BOUNDED_AGG_CONTRACT), org.value);
+    seqinherit_table _seqinherit(name(BOUNDED_AGG_CONTRACT), org.value);
+    badgehll_table _badgehll(_self, account.value);
+    balances_table _balances(_self, account.value);
+    sender_hll::dense_registers M = {};
+    for(auto badge_agg_seq_id : badge_agg_seq_ids) {
+        symbol badge_symbol;
+        auto badgestatus_itr = badgestatus_t.find(badge_agg_seq_id);
+        if(badgestatus_itr != badgestatus_t.end()) {
+            badge_symbol = badgestatus_itr->badge_symbol;
+        } else {
+            auto seqinherit_itr = find_inherit_block(_seqinherit, badge_agg_seq_id);
+            if(seqinherit_itr == _seqinherit.end()) {
+                continue;
+            }
+            badge_symbol = seqinherit_itr->badge_symbols[badge_agg_seq_id - seqinherit_itr->first_badge_agg_seq_id];
+        }
+        auto badgehll_itr = _badgehll.find(badge_symbol.code().raw());
+        if(badgehll_itr != _badgehll.end()) {
+            auto seq_hll_itr = find_seq_hll(badgehll_itr->seq_hlls, badge_agg_seq_id);
+            if(seq_hll_itr != badgehll_itr->seq_hlls.end()) {
+                sender_hll::merge_into(seq_hll_itr->hll, M.data());
+                continue;
+            }
+        }
+        auto balances_itr = _balances.find(badge_agg_seq_id);
+        if(balances_itr != _balances.end()) {
+            sender_hll::merge_into(balances_itr->hll, M.data());
+        }
+    }
+    return sender_hll::dense_hll::estimate_int(M.data());
 }
 
 ACTION boundedhll::newemission (
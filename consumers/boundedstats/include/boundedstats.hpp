@@ -1,6 +1,10 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/crypto.hpp>
+#include <leaderboard.hpp>
+#include <topholders.hpp>
+#include <quantiles.hpp>
+#include <eventlog.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -12,11 +16,34 @@ using namespace eosio;
 #define SUBSCRIPTION_CONTRACT "subsyyyyyyyy"
 
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
+#define NEW_BADGE_BATCH_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifybatch"
+#define NEW_BADGE_COMPACT_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachv2"
+
 
 CONTRACT boundedstats : public contract {
   public:
     using contract::contract;
 
+    struct achievement_event {
+        asset badge_asset;
+        name from;
+        name to;
+        string memo;
+    };
+
+    struct balancequantiles {
+        uint64_t holders;
+        uint64_t p50;
+        uint64_t p90;
+        uint64_t p99;
+        bool complete;      // false when some sequence had holders before its sketch, see distribution
+    };
+
+    struct balancehistogram {
+        vector<uint32_t> log2_counts;
+        bool complete;      // as in balancequantiles, see histogram
+    };
+
     [[eosio::on_notify(NEW_BADGE_ISSUANCE_NOTIFICATION)]] void notifyachiev(
         name org,
         asset badge_asset, 
@@ -25,12 +52,60 @@ CONTRACT boundedstats : public contract {
         string memo, 
         vector<name> notify_accounts);
 
+    [[eosio::on_notify(NEW_BADGE_BATCH_NOTIFICATION)]] void notifybatch(
+        name org,
+        name notify_account,
+        vector<achievement_event> events);
 
-    ACTION activate(name org, symbol agg_symbol, vector<symbol> badge_symbols);
+    [[eosio::on_notify(NEW_BADGE_COMPACT_NOTIFICATION)]] void notifyachv2(
+        name org,
+        name notify_account,
+        symbol badge_symbol,
+        uint64_t amount,
+        name from,
+        name to,
+        uint64_t event_seq,
+        std::optional<checksum256> memo_hash);
+
+    // top_k > 0 ranks only the top_k highest balances of each sequence of the badges, 0 ranks every account.
+    // sequences ranked under an earlier setting follow the new one on their next update, see init_top_k.
+    ACTION activate(name org, symbol agg_symbol, vector<symbol> badge_symbols, uint16_t top_k);
 
     ACTION deactivate(name org, symbol agg_symbol, vector<symbol> badge_symbols);
 
+    ACTION crank(name org, uint16_t max_events);
+
+    // moves up to max_accounts accounts of badge_agg_seq_id from the legacy ranks rows into the leaderboard
+    ACTION migrateranks(uint64_t badge_agg_seq_id, uint16_t max_accounts);
+
+    // erases up to max_rows rows of the ranking badge_agg_seq_id no longer reads: its leaderboard
+    // while in top-K mode, otherwise the holders left from an earlier top-K period
+    ACTION freeranks(uint64_t badge_agg_seq_id, uint16_t max_rows);
+
+    // competition rank of account in badge_agg_seq_id, 0 if it holds none or is outside the top-K
+    [[eosio::action, eosio::read_only]]
+    uint64_t rankof(uint64_t badge_agg_seq_id, name account);
+
+    // count accounts of badge_agg_seq_id from position first_rank, highest balance first.
+    // accounts still in legacy ranks rows are left out until migrateranks has moved them.
+    [[eosio::action, eosio::read_only]]
+    vector<rankentry> rankrange(uint64_t badge_agg_seq_id, uint64_t first_rank, uint32_t count);
+
+    // balance quantiles over the holders of the given sequences merged, an account
+    // holding in several of them is counted once per sequence.
+    // only complete when every sequence's first holder was recorded by its sketch.
+    [[eosio::action, eosio::read_only]]
+    balancequantiles balancequant(name org, vector<uint64_t> badge_agg_seq_ids);
+
+    // holders of the given sequences merged per power of two of the balance, bucket i is [2^i, 2^(i+1)).
+    // only complete when every sequence's first holder was recorded by its histogram.
+    [[eosio::action, eosio::read_only]]
+    balancehistogram balancehist(name org, vector<uint64_t> badge_agg_seq_ids);
+
   private:
+    // 8 buckets per power of two of the balance
+    typedef quantile::LogLinearSketch<3> balance_sketch;
+
     //scoped by agg_symbol
     TABLE  statssetting {
         symbol badge_symbol;
@@ -38,6 +113,14 @@ CONTRACT boundedstats : public contract {
     };
     typedef multi_index<"statssetting"_n, statssetting> statssetting_table;
 
+    // scoped by agg_symbol, only present for badges activated in top-K mode
+    TABLE topksetting {
+        symbol badge_symbol;
+        uint16_t top_k;
+        uint64_t primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<"topksetting"_n, topksetting> topksetting_table;
+
     // scoped by org
     TABLE counts {
         uint64_t badge_agg_seq_id;
@@ -47,7 +130,26 @@ CONTRACT boundedstats : public contract {
     };
     typedef multi_index<"counts"_n, counts> counts_table;
 
-    // scoped by badge_agg_seq_id
+    // scoped by org, holders of a badge_agg_seq_id bucketed by balance, see balance_sketch
+    TABLE distribution {
+        uint64_t badge_agg_seq_id;
+        vector<uint32_t> balance_counts;
+        bool complete;      // the row was created by the first holder of the sequence
+        uint64_t primary_key() const { return badge_agg_seq_id; }
+    };
+    typedef multi_index<"distribution"_n, distribution> distribution_table;
+
+    // scoped by org, holders of a badge_agg_seq_id per power of two of the balance, see quantile::Log2Histogram
+    TABLE histogram {
+        uint64_t badge_agg_seq_id;
+        vector<uint32_t> log2_counts;
+        bool complete;      // the row was created by the first holder of the sequence
+        uint64_t primary_key() const { return badge_agg_seq_id; }
+    };
+    typedef multi_index<"histogram"_n, histogram> histogram_table;
+
+    // scoped by badge_agg_seq_id, superseded by the leaderboard of the same scope.
+    // rows left here are moved over by migrateranks or when their accounts next change.
     TABLE ranks {
         vector<name> accounts;
         uint64_t balance;
@@ -55,6 +157,17 @@ CONTRACT boundedstats : public contract {
     };
     typedef multi_index<"ranks"_n, ranks> ranks_table;
 
+    // scoped by badge_agg_seq_id, count an account was last applied at. the crank adds a
+    // row for each account it applies, since a count read back from boundagg minus the
+    // drained amounts is not the applied one once the event log has dropped events.
+    // pushed issuances keep existing rows current.
+    TABLE applied {
+        name account;
+        uint64_t balance;
+        uint64_t primary_key() const { return account.value; }
+    };
+    typedef multi_index<"applied"_n, applied> applied_table;
+
     // scoped by org.
     TABLE badgestatus {
         uint64_t badge_agg_seq_id; // Primary key: Unique ID for each badge-sequence association
@@ -67,16 +180,16 @@ CONTRACT boundedstats : public contract {
         uint64_t primary_key() const { return badge_agg_seq_id; }
         uint128_t by_agg_seq() const { return combine_keys(agg_symbol.code().raw(), seq_id); }
 
-        checksum256 by_badge_status() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
-            return sha256(data.data(), data.size());
+        // secondary keys pack the raw values into the words of a checksum256, nothing is hashed
+        checksum256 by_badge_status() const { return badge_status_key(badge_symbol, badge_status, seq_status); }
+        checksum256 by_agg_seq_badge() const { return agg_seq_badge_key(agg_symbol, seq_id, badge_symbol); }
+
+        static checksum256 badge_status_key(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
+            return checksum256::make_from_word_sequence<uint64_t>(badge_symbol.code().raw(), badge_status.value, seq_status.value, uint64_t(0));
         }
 
-        checksum256 by_agg_seq_badge() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = agg_symbol.code().to_string() + std::to_string(seq_id) + badge_symbol.code().to_string();
-            return sha256(data.data(), data.size());
+        static checksum256 agg_seq_badge_key(const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+            return checksum256::make_from_word_sequence<uint64_t>(agg_symbol.code().raw(), seq_id, badge_symbol.code().raw(), uint64_t(0));
         }
 
         static uint128_t combine_keys(uint64_t a, uint64_t b) {
@@ -90,6 +203,60 @@ CONTRACT boundedstats : public contract {
         eosio::indexed_by<"aggseqbadge"_n, eosio::const_mem_fun<badgestatus, checksum256, &badgestatus::by_agg_seq_badge>>
     > badgestatus_table;
 
+    // scoped by boundagg contract, rows past last_badge_agg_seq_id still carry the legacy sha256 keys until done
+    TABLE bsmigration {
+        name org;
+        uint64_t last_badge_agg_seq_id;
+        bool done;
+        auto primary_key() const { return org.value; }
+    };
+    typedef multi_index<name("bsmigration"), bsmigration> bsmigration_table;
+
+    bool badgestatus_migrated(name org) {
+        bsmigration_table _bsmigration(name(BOUNDED_AGG_CONTRACT), name(BOUNDED_AGG_CONTRACT).value);
+        auto bsmigration_itr = _bsmigration.find(org.value);
+        return bsmigration_itr != _bsmigration.end() && bsmigration_itr->done;
+    }
+
+    struct routeentry {
+        uint64_t badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+    };
+
+    // scoped by org, see boundagg::activeroute
+    TABLE activeroute {
+        symbol badge_symbol;
+        vector<routeentry> routes;
+        auto primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<name("activeroutes"), activeroute> activeroute_table;
+
+    // active (badge, sequence) pairs of badge_symbol, see boundagg::active_routes
+    vector<routeentry> active_routes(name org, const symbol& badge_symbol) {
+        if(badgestatus_migrated(org)) {
+            activeroute_table _activeroute(name(BOUNDED_AGG_CONTRACT), org.value);
+            auto activeroute_itr = _activeroute.find(badge_symbol.code().raw());
+            return activeroute_itr == _activeroute.end() ? vector<routeentry>() : activeroute_itr->routes;
+        }
+
+        vector<routeentry> routes;
+        badgestatus_table badgestatus_t(name(BOUNDED_AGG_CONTRACT), org.value);
+        auto by_status_index = badgestatus_t.get_index<"bybadgestat"_n>();
+        vector<checksum256> keys = {
+            badgestatus::badge_status_key(badge_symbol, "active"_n, "active"_n),
+            hash_active_status(badge_symbol, "active"_n, "active"_n)};
+        for(auto& key : keys) {
+            auto itr = by_status_index.find(key);
+            while(itr != by_status_index.end() && itr->badge_symbol == badge_symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
+                routes.push_back({itr->badge_agg_seq_id, itr->agg_symbol, itr->seq_id});
+                itr++;
+            }
+        }
+        return routes;
+    }
+
+    // legacy sha256 keys, only used for rows not yet re-indexed by boundagg::migratebs
     checksum256 hash_active_status(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
         // Create a data string from badge_symbol, badge_status, and seq_status
         string data_str = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
@@ -136,40 +303,56 @@ CONTRACT boundedstats : public contract {
         check(false, failure_identifier + "Calling contract not in authorized list of accounts for action " + action.to_string());
     }
 
-    void update_rank(name org, name account, uint64_t badge_agg_seq_id, uint64_t old_balance, uint64_t new_balance) {
-
-        ranks_table _ranks(get_self(), badge_agg_seq_id); // Use badge_agg_seq_id as scope
-        if (old_balance != new_balance && old_balance != 0) {
+    // board and _ranks are scoped by badge_agg_seq_id, top replaces both for sequences in top-K mode
+    void update_rank(topholders& top, leaderboard& board, ranks_table& _ranks, name account, uint64_t old_balance, uint64_t new_balance) {
+        if (top.capacity() > 0) {
+            top.update(account, new_balance, get_self());
+            return;
+        }
+        if (old_balance != new_balance && old_balance != 0 && !board.remove(account, old_balance, get_self())) {
             auto old_itr = _ranks.find(old_balance);
-            check(old_itr != _ranks.end(),"not found in boundedstats");
-            auto old_names = old_itr->accounts;
-            old_names.erase(std::remove(old_names.begin(), old_names.end(), account), old_names.end());
-            if (old_names.empty()) {
-                _ranks.erase(old_itr); // Remove the score entry if no names are left
-            } else {
-                _ranks.modify(old_itr, get_self(), [&](auto& entry) {
-                    entry.accounts = old_names;
+            // a leaderboard restarted after top-K mode has not seen every holder yet
+            check(old_itr != _ranks.end() || top.restarted(),"not found in boundedstats");
+            if (old_itr != _ranks.end()) {
+                auto old_names = old_itr->accounts;
+                old_names.erase(std::remove(old_names.begin(), old_names.end(), account), old_names.end());
+                if (old_names.empty()) {
+                    _ranks.erase(old_itr); // Remove the score entry if no names are left
+                } else {
+                    _ranks.modify(old_itr, get_self(), [&](auto& entry) {
+                        entry.accounts = old_names;
+                    });
+                }
+            }
+        }
+        board.insert(account, new_balance, get_self());
+    }
+
+    // _counts is scoped by org
+    // balance account was applied at before new_balance, fallback if it has no applied row.
+    // records new_balance, untracked accounts get a row only when track is set.
+    uint64_t swap_applied(applied_table& _applied, name account, uint64_t fallback, uint64_t new_balance, bool track) {
+        auto applied_itr = _applied.find(account.value);
+        if(applied_itr == _applied.end()) {
+            if(track) {
+                _applied.emplace(get_self(), [&](auto& row) {
+                    row.account = account;
+                    row.balance = new_balance;
                 });
             }
+            return fallback;
         }
-        auto new_itr = _ranks.find(new_balance);
-        if (new_itr == _ranks.end()) {
-            _ranks.emplace(get_self(), [&](auto& entry) {
-                entry.balance = new_balance;
-                entry.accounts.push_back(account);
+        uint64_t old_balance = applied_itr->balance;
+        if(old_balance != new_balance) {
+            _applied.modify(applied_itr, get_self(), [&](auto& row) {
+                row.balance = new_balance;
             });
-        } else {
-            if (std::find(new_itr->accounts.begin(), new_itr->accounts.end(), account) == new_itr->accounts.end()) {
-                _ranks.modify(new_itr, get_self(), [&](auto& entry) {
-                    entry.accounts.push_back(account);
-                });
-            } // If player name already exists for this score, no action needed
         }
-
+        return old_balance;
     }
 
-    void update_count(name org, name account, uint64_t badge_agg_seq_id, uint64_t old_balance, uint64_t new_balance) {
-        counts_table _counts(get_self(), org.value);
+    // returns total_recipients after the update
+    uint64_t update_count(counts_table& _counts, uint64_t badge_agg_seq_id, uint64_t old_balance, uint64_t new_balance) {
         auto counts_itr = _counts.find(badge_agg_seq_id);
         uint64_t total_recipients;
         uint64_t total_issued;
@@ -192,6 +375,88 @@ CONTRACT boundedstats : public contract {
                 entry.total_issued = total_issued;
             });
         }
+        return total_recipients;
+    }
+
+    // _distribution is scoped by org, balances issued before the row existed are not in it.
+    // first_holder: this update made the first recipient of the sequence, so none is missing.
+    void update_distribution(distribution_table& _distribution, uint64_t badge_agg_seq_id, uint64_t old_balance, uint64_t new_balance, bool first_holder) {
+        auto distribution_itr = _distribution.find(badge_agg_seq_id);
+        if(distribution_itr == _distribution.end()) {
+            _distribution.emplace(get_self(), [&](auto& row) {
+                row.badge_agg_seq_id = badge_agg_seq_id;
+                row.complete = first_holder;
+                balance_sketch(row.balance_counts).move(0, new_balance);
+            });
+        } else {
+            _distribution.modify(distribution_itr, get_self(), [&](auto& row) {
+                balance_sketch(row.balance_counts).move(old_balance, new_balance);
+            });
+        }
+    }
+
+    // _histogram is scoped by org, the row is only written when the balance changes bucket.
+    // first_holder as in update_distribution.
+    void update_histogram(histogram_table& _histogram, uint64_t badge_agg_seq_id, uint64_t old_balance, uint64_t new_balance, bool first_holder) {
+        auto histogram_itr = _histogram.find(badge_agg_seq_id);
+        if(histogram_itr == _histogram.end()) {
+            _histogram.emplace(get_self(), [&](auto& row) {
+                row.badge_agg_seq_id = badge_agg_seq_id;
+                row.complete = first_holder;
+                quantile::Log2Histogram(row.log2_counts).move(0, new_balance);
+            });
+        } else if(quantile::Log2Histogram::moves(old_balance, new_balance)) {
+            _histogram.modify(histogram_itr, get_self(), [&](auto& row) {
+                quantile::Log2Histogram(row.log2_counts).move(old_balance, new_balance);
+            });
+        }
+    }
+
+    // active badge_agg_seq_ids of badge_symbol that have stats enabled
+    vector<uint64_t> stats_badge_agg_seq_ids(name org, const symbol& badge_symbol) {
+        vector<uint64_t> badge_agg_seq_ids;
+        for(auto& route : active_routes(org, badge_symbol)) {
+            statssetting_table _statssetting(get_self(), route.agg_symbol.code().raw());
+            if(_statssetting.find(badge_symbol.code().raw()) != _statssetting.end()) {
+                badge_agg_seq_ids.push_back(route.badge_agg_seq_id);
+                init_top_k(route.agg_symbol, badge_symbol, route.badge_agg_seq_id);
+            }
+        }
+        return badge_agg_seq_ids;
+    }
+
+    // a sequence takes the top-K setting of its agg and badge the first time it is ranked,
+    // seeded from the leaderboard in case the badge was switched to top-K mid-sequence.
+    // like statistics::settopk it waits until migrateranks has emptied the legacy ranks rows,
+    // and until freeranks has erased the holders of an earlier top-K period.
+    // a changed top_k resizes the holders. once the setting is gone the sequence leaves top-K
+    // mode as soon as freeranks has erased its leaderboard, which then restarts empty.
+    void init_top_k(const symbol& agg_symbol, const symbol& badge_symbol, uint64_t badge_agg_seq_id) {
+        topksetting_table _topksetting(get_self(), agg_symbol.code().raw());
+        auto topksetting_itr = _topksetting.find(badge_symbol.code().raw());
+        topholders top(get_self(), badge_agg_seq_id);
+        uint16_t capacity = top.capacity();
+        if(topksetting_itr == _topksetting.end()) {
+            if(capacity > 0 && leaderboard(get_self(), badge_agg_seq_id).accounts() == 0) {
+                top.leave(get_self());
+            }
+            return;
+        }
+        if(capacity > 0) {
+            if(capacity != topksetting_itr->top_k) {
+                top.resize(topksetting_itr->top_k, get_self());
+            }
+            return;
+        }
+        ranks_table _ranks(get_self(), badge_agg_seq_id);
+        if(_ranks.begin() != _ranks.end() || top.size() > 0) {
+            return;
+        }
+        top.set_capacity(topksetting_itr->top_k, get_self());
+        leaderboard board(get_self(), badge_agg_seq_id);
+        for(auto& entry : board.range(1, topksetting_itr->top_k)) {
+            top.update(entry.account, entry.balance, get_self());
+        }
     }
 
     // Function to fetch the new balance from the achievements table, scoped by account.
@@ -212,9 +477,41 @@ CONTRACT boundedstats : public contract {
     
 
 
+    // seq_recipient_totals: badge_agg_seq_id -> recipient -> amount issued.
+    // pending: amounts already in boundagg counts that were issued after seq_recipient_totals.
+    // track: take old balances from applied rows, see applied.
+    void apply_seq_totals(name org, const std::map<uint64_t, std::map<name, uint64_t>>& seq_recipient_totals, const std::map<std::pair<uint64_t, name>, uint64_t>& pending, bool track) {
+        counts_table _counts(get_self(), org.value);
+        distribution_table _distribution(get_self(), org.value);
+        histogram_table _histogram(get_self(), org.value);
+        for(auto& [badge_agg_seq_id, recipient_totals] : seq_recipient_totals) {
+            topholders top(get_self(), badge_agg_seq_id);
+            leaderboard board(get_self(), badge_agg_seq_id);
+            ranks_table _ranks(get_self(), badge_agg_seq_id);
+            applied_table _applied(get_self(), badge_agg_seq_id);
+            for(auto& [to, amount] : recipient_totals) {
+                uint64_t new_balance = get_new_balance(to, badge_agg_seq_id);
+                auto pending_itr = pending.find({badge_agg_seq_id, to});
+                if(pending_itr != pending.end()) {
+                    new_balance -= pending_itr->second;
+                }
+                uint64_t old_balance = swap_applied(_applied, to, new_balance - amount, new_balance, track);
+                update_rank(top, board, _ranks, to, old_balance, new_balance);
+                bool first_holder = update_count(_counts, badge_agg_seq_id, old_balance, new_balance) == 1 && old_balance == 0;
+                update_distribution(_distribution, badge_agg_seq_id, old_balance, new_balance, first_holder);
+                update_histogram(_histogram, badge_agg_seq_id, old_balance, new_balance, first_holder);
+            }
+        }
+    }
+
     struct billing_args {
       name org;
       uint8_t actions_used;
     };
 
+    struct billbulk_args {
+      name org;
+      uint64_t actions_used;
+    };
+
 };
@@ -4,23 +4,23 @@
 void boundedstats::notifyachiev(name org, asset badge_asset, name from, name to, string memo, vector<name> notify_accounts) {
     string action_name = "settings";
     string failure_identifier = "CONTRACT: boundedstats, ACTION: " + action_name + ", MESSAGE: ";
-    badgestatus_table badgestatus(name(BOUNDED_AGG_CONTRACT), org.value); // Adjust scope as necessary
-    auto badge_status_index = badgestatus.get_index<"bybadgestat"_n>(); // Correct index name
-    auto hashed_active_status = hash_active_status(badge_asset.symbol, "active"_n, "active"_n);
-    auto itr = badge_status_index.find(hashed_active_status);
+    vector<uint64_t> badge_agg_seq_ids = stats_badge_agg_seq_ids(org, badge_asset.symbol);
+    counts_table _counts(get_self(), org.value);
+    distribution_table _distribution(get_self(), org.value);
+    histogram_table _histogram(get_self(), org.value);
     uint8_t actions_used = 0;
-    while(itr != badge_status_index.end() && itr->badge_symbol == badge_asset.symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
-        statssetting_table _statssetting(get_self(), itr->agg_symbol.code().raw());
-        auto statssetting_itr = _statssetting.find(itr->badge_symbol.code().raw());
-        if(statssetting_itr != _statssetting.end()) {
-            uint64_t new_balance = get_new_balance(to, itr->badge_agg_seq_id);
-            uint64_t old_balance = new_balance - badge_asset.amount;
-            update_rank(org, to, itr->badge_agg_seq_id, old_balance, new_balance);
-            update_count(org, to, itr->badge_agg_seq_id, old_balance, new_balance);
-            actions_used ++;
-        }
-
-        itr++;
+    for(auto badge_agg_seq_id : badge_agg_seq_ids) {
+        topholders top(get_self(), badge_agg_seq_id);
+        leaderboard board(get_self(), badge_agg_seq_id);
+        ranks_table _ranks(get_self(), badge_agg_seq_id);
+        applied_table _applied(get_self(), badge_agg_seq_id);
+        uint64_t new_balance = get_new_balance(to, badge_agg_seq_id);
+        uint64_t old_balance = swap_applied(_applied, to, new_balance - badge_asset.amount, new_balance, false);
+        update_rank(top, board, _ranks, to, old_balance, new_balance);
+        bool first_holder = update_count(_counts, badge_agg_seq_id, old_balance, new_balance) == 1 && old_balance == 0;
+        update_distribution(_distribution, badge_agg_seq_id, old_balance, new_balance, first_holder);
+        update_histogram(_histogram, badge_agg_seq_id, old_balance, new_balance, first_holder);
+        actions_used ++;
     }
 
     action {
@@ -33,12 +33,116 @@ void boundedstats::notifyachiev(name org, asset badge_asset, name from, name to,
     }.send();
 }
 
-ACTION boundedstats::activate(name org, symbol agg_symbol, vector<symbol> badge_symbols) {
+void boundedstats::notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash) {
+    if (notify_account != get_self()) {
+        return;
+    }
+    // v2 events carry neither memo nor notify_accounts, neither is used here
+    notifyachiev(org, asset(amount, badge_symbol), from, to, "", {});
+}
+
+void boundedstats::notifybatch(name org, name notify_account, vector<achievement_event> events) {
+    if(notify_account != get_self()) {
+        return;
+    }
+
+    // boundagg has already applied the whole batch, so each (badge_agg_seq_id, recipient)
+    // pair is updated once from its summed amount.
+    std::map<symbol, vector<uint64_t>> badge_agg_seq_ids;
+    std::map<uint64_t, std::map<name, uint64_t>> seq_recipient_totals;
+    uint64_t actions_used = 0;
+    for(auto& event : events) {
+        auto ids_itr = badge_agg_seq_ids.find(event.badge_asset.symbol);
+        if(ids_itr == badge_agg_seq_ids.end()) {
+            ids_itr = badge_agg_seq_ids.emplace(event.badge_asset.symbol, stats_badge_agg_seq_ids(org, event.badge_asset.symbol)).first;
+        }
+        for(auto badge_agg_seq_id : ids_itr->second) {
+            seq_recipient_totals[badge_agg_seq_id][event.to] += event.badge_asset.amount;
+        }
+        actions_used += ids_itr->second.size();
+    }
+
+    apply_seq_totals(org, seq_recipient_totals, {}, false);
+
+    action {
+        permission_level{get_self(), name("active")},
+        name(SUBSCRIPTION_CONTRACT),
+        name("billbulk"),
+        billbulk_args {
+            .org = org,
+            .actions_used = actions_used}
+    }.send();
+}
+
+ACTION boundedstats::crank(name org, uint16_t max_events) {
+    uint64_t head_log_seq = 0;
+    eventlog_reader event_log(get_self(), name(ORCHESTRATOR_CONTRACT));
+    vector<eventlog> events = event_log.drain(org, max_events, head_log_seq);
+    if(events.empty()) {
+        return;
+    }
+
+    std::map<uint64_t, bool> followed_badges;
+    std::map<symbol, vector<uint64_t>> badge_agg_seq_ids;
+    std::map<uint64_t, std::map<name, uint64_t>> seq_recipient_totals;
+    uint64_t actions_used = 0;
+    for(auto& event : events) {
+        if(!event_log.follows_badge(org, event.badge_symbol, followed_badges)) {
+            continue;
+        }
+        auto ids_itr = badge_agg_seq_ids.find(event.badge_symbol);
+        if(ids_itr == badge_agg_seq_ids.end()) {
+            ids_itr = badge_agg_seq_ids.emplace(event.badge_symbol, stats_badge_agg_seq_ids(org, event.badge_symbol)).first;
+        }
+        for(auto badge_agg_seq_id : ids_itr->second) {
+            seq_recipient_totals[badge_agg_seq_id][event.to] += event.amount;
+        }
+        actions_used += ids_itr->second.size();
+    }
+    if(actions_used == 0) {
+        return;
+    }
+
+    // boundagg counts already include issuances logged after this chunk
+    std::map<std::pair<uint64_t, name>, uint64_t> pending;
+    for(auto& later : event_log.pending(org, events.back().log_seq, head_log_seq)) {
+        auto ids_itr = badge_agg_seq_ids.find(later.badge_symbol);
+        if(ids_itr == badge_agg_seq_ids.end()) {
+            continue;
+        }
+        for(auto badge_agg_seq_id : ids_itr->second) {
+            pending[{badge_agg_seq_id, later.to}] += later.amount;
+        }
+    }
+
+    apply_seq_totals(org, seq_recipient_totals, pending, true);
+
+    action {
+        permission_level{get_self(), name("active")},
+        name(SUBSCRIPTION_CONTRACT),
+        name("billbulk"),
+        billbulk_args {
+            .org = org,
+            .actions_used = actions_used}
+    }.send();
+}
+
+ACTION boundedstats::activate(name org, symbol agg_symbol, vector<symbol> badge_symbols, uint16_t top_k) {
     string action_name = "activate";
     string failure_identifier = "CONTRACT: boundedstats, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
+    check(top_k <= TOPHOLDERS_MAX_CAPACITY, failure_identifier + "top_k must not exceed " + std::to_string(TOPHOLDERS_MAX_CAPACITY));
 
     statssetting_table _statssetting(get_self(), agg_symbol.code().raw());
+    topksetting_table _topksetting(get_self(), agg_symbol.code().raw());
     for(auto i = 0 ; i < badge_symbols.size(); i++) {
         auto itr = _statssetting.find(badge_symbols[i].code().raw());
         check(itr == _statssetting.end(), failure_identifier + badge_symbols[i].code().to_string() +" record already present in statssetting table");
@@ -46,6 +150,13 @@ ACTION boundedstats::activate(name org, symbol agg_symbol, vector<symbol> badge_
         _statssetting.emplace(get_self(), [&](auto& entry) {
             entry.badge_symbol = badge_symbols[i];
         }); 
+
+        if(top_k > 0) {
+            _topksetting.emplace(get_self(), [&](auto& entry) {
+                entry.badge_symbol = badge_symbols[i];
+                entry.top_k = top_k;
+            });
+        }
     }
 }
 
@@ -55,10 +166,129 @@ ACTION boundedstats::deactivate(name org, symbol agg_symbol, vector<symbol> badg
     check_internal_auth(name(action_name), failure_identifier);
 
     statssetting_table _statssetting(get_self(), agg_symbol.code().raw());
+    topksetting_table _topksetting(get_self(), agg_symbol.code().raw());
     for(auto i = 0 ; i < badge_symbols.size(); i++) {
         auto itr = _statssetting.find(badge_symbols[i].code().raw());
         check(itr != _statssetting.end(), failure_identifier + badge_symbols[i].code().to_string() +" record not present");
 
         _statssetting.erase(itr);
+
+        auto topksetting_itr = _topksetting.find(badge_symbols[i].code().raw());
+        if(topksetting_itr != _topksetting.end()) {
+            _topksetting.erase(topksetting_itr);
+        }
+    }
+}
+
+ACTION boundedstats::migrateranks(uint64_t badge_agg_seq_id, uint16_t max_accounts) {
+    string action_name = "migrateranks";
+    string failure_identifier = "CONTRACT: boundedstats, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    leaderboard board(get_self(), badge_agg_seq_id);
+    ranks_table _ranks(get_self(), badge_agg_seq_id);
+    uint16_t moved = 0;
+    auto ranks_itr = _ranks.begin();
+    while(ranks_itr != _ranks.end() && moved < max_accounts) {
+        auto names = ranks_itr->accounts;
+        while(!names.empty() && moved < max_accounts) {
+            board.insert(names.back(), ranks_itr->balance, get_self());
+            names.pop_back();
+            moved++;
+        }
+        if(names.empty()) {
+            ranks_itr = _ranks.erase(ranks_itr);
+        } else {
+            _ranks.modify(ranks_itr, get_self(), [&](auto& entry) {
+                entry.accounts = names;
+            });
+        }
+    }
+}
+
+ACTION boundedstats::freeranks(uint64_t badge_agg_seq_id, uint16_t max_rows) {
+    string action_name = "freeranks";
+    string failure_identifier = "CONTRACT: boundedstats, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    topholders top(get_self(), badge_agg_seq_id);
+    if(top.capacity() > 0) {
+        leaderboard board(get_self(), badge_agg_seq_id);
+        board.clear(max_rows);
+    } else {
+        top.clear(max_rows, get_self());
+    }
+}
+
+uint64_t boundedstats::rankof(uint64_t badge_agg_seq_id, name account) {
+    achievements_table achievements(name(BOUNDED_AGG_CONTRACT), account.value);
+    auto achv_itr = achievements.find(badge_agg_seq_id);
+    if(achv_itr == achievements.end()) {
+        return 0;
+    }
+    topholders top(get_self(), badge_agg_seq_id);
+    if(top.capacity() > 0) {
+        return top.rank_of(account);
+    }
+    leaderboard board(get_self(), badge_agg_seq_id);
+    uint64_t rank = board.rank_of(achv_itr->count);
+
+    // legacy rows not yet migrated still hold some of the higher balances
+    ranks_table _ranks(get_self(), badge_agg_seq_id);
+    for(auto ranks_itr = _ranks.upper_bound(achv_itr->count); ranks_itr != _ranks.end(); ranks_itr++) {
+        rank += ranks_itr->accounts.size();
+    }
+    return rank;
+}
+
+vector<rankentry> boundedstats::rankrange(uint64_t badge_agg_seq_id, uint64_t first_rank, uint32_t count) {
+    topholders top(get_self(), badge_agg_seq_id);
+    if(top.capacity() > 0) {
+        return top.range(first_rank, count);
+    }
+    leaderboard board(get_self(), badge_agg_seq_id);
+    return board.range(first_rank, count);
+}
+
+boundedstats::balancequantiles boundedstats::balancequant(name org, vector<uint64_t> badge_agg_seq_ids) {
+    distribution_table _distribution(get_self(), org.value);
+    counts_table _counts(get_self(), org.value);
+    vector<uint32_t> counts;
+    balance_sketch merged(counts);
+    bool complete = true;
+    for(auto badge_agg_seq_id : badge_agg_seq_ids) {
+        auto distribution_itr = _distribution.find(badge_agg_seq_id);
+        if(distribution_itr != _distribution.end()) {
+            merged.merge(distribution_itr->balance_counts);
+            complete = complete && distribution_itr->complete;
+        } else if(_counts.find(badge_agg_seq_id) != _counts.end()) {
+            // holders recorded before the sketch existed, none issued since
+            complete = false;
+        }
+    }
+    return balancequantiles{
+        .holders = balance_sketch::total(counts),
+        .p50 = balance_sketch::quantile(counts, 500),
+        .p90 = balance_sketch::quantile(counts, 900),
+        .p99 = balance_sketch::quantile(counts, 990),
+        .complete = complete};
+}
+
+boundedstats::balancehistogram boundedstats::balancehist(name org, vector<uint64_t> badge_agg_seq_ids) {
+    histogram_table _histogram(get_self(), org.value);
+    counts_table _counts(get_self(), org.value);
+    vector<uint32_t> counts;
+    quantile::Log2Histogram merged(counts);
+    bool complete = true;
+    for(auto badge_agg_seq_id : badge_agg_seq_ids) {
+        auto histogram_itr = _histogram.find(badge_agg_seq_id);
+        if(histogram_itr != _histogram.end()) {
+            merged.merge(histogram_itr->log2_counts);
+            complete = complete && histogram_itr->complete;
+        } else if(_counts.find(badge_agg_seq_id) != _counts.end()) {
+            // holders recorded before the histogram existed, none issued since
+            complete = false;
+        }
     }
+    return balancehistogram{counts, complete};
 }
@@ -0,0 +1,157 @@
+#if !defined(EVENTLOG_HPP)
+#define EVENTLOG_HPP
+
+/**
+ * @file eventlog.hpp
+ * @brief Reader side of the orchestrator event log for pull consumers
+ *
+ * The orchestrator writes issuances of badges with a pull consumer into a
+ * per org ring of EVENT_LOG_SIZE slots. Each consumer keeps its own cursor
+ * and drains the ring from a crank; entries overwritten before they were
+ * read are counted, not replayed.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/asset.hpp>
+#include <algorithm>
+#include <map>
+#include <vector>
+
+// must match EVENT_LOG_SIZE of the orchestrator
+#define EVENT_LOG_SIZE 512
+
+// scoped by org, written by orchestrator
+TABLE badge {
+    eosio::symbol badge_symbol;
+    std::vector<eosio::name> notify_accounts;
+    std::string offchain_lookup_data;
+    std::string onchain_lookup_data;
+    uint64_t rarity_counts;
+    auto primary_key() const { return badge_symbol.code().raw(); }
+};
+typedef eosio::multi_index<"badge"_n, badge> badge_table;
+
+// scoped by org, written by orchestrator
+TABLE eventlog {
+    uint64_t slot;
+    uint64_t log_seq;
+    eosio::symbol badge_symbol;
+    uint64_t amount;
+    eosio::name from;
+    eosio::name to;
+    auto primary_key() const { return slot; }
+};
+typedef eosio::multi_index<"eventlogs"_n, eventlog> eventlog_table;
+
+// scoped by orchestrator
+TABLE loghead {
+    eosio::name org;
+    uint64_t last_log_seq;
+    auto primary_key() const { return org.value; }
+};
+typedef eosio::multi_index<"logheads"_n, loghead> loghead_table;
+
+// scoped by contract
+// lag behind the orchestrator event log is head_log_seq - last_log_seq as of the last crank
+TABLE logcursor {
+    eosio::name org;
+    uint64_t last_log_seq;
+    uint64_t head_log_seq;
+    uint64_t dropped_events;
+    auto primary_key() const { return org.value; }
+};
+typedef eosio::multi_index<"logcursors"_n, logcursor> logcursor_table;
+
+class eventlog_reader {
+public:
+    eventlog_reader(eosio::name self, eosio::name orchestrator) : self_(self), orchestrator_(orchestrator) {}
+
+    /**
+     * Returns up to max_events unread log entries of org and moves the cursor
+     * past them. head_log_seq is set to the orchestrator's last log_seq.
+     */
+    std::vector<eventlog> drain(eosio::name org, uint16_t max_events, uint64_t& head_log_seq) {
+        std::vector<eventlog> events;
+        loghead_table _loghead(orchestrator_, orchestrator_.value);
+        auto loghead_itr = _loghead.find(org.value);
+        if (loghead_itr == _loghead.end()) {
+            return events;
+        }
+        head_log_seq = loghead_itr->last_log_seq;
+
+        logcursor_table _logcursor(self_, self_.value);
+        auto logcursor_itr = _logcursor.find(org.value);
+        uint64_t last_log_seq = (logcursor_itr == _logcursor.end()) ? 0 : logcursor_itr->last_log_seq;
+        uint64_t dropped_events = 0;
+        if (head_log_seq > EVENT_LOG_SIZE && last_log_seq < head_log_seq - EVENT_LOG_SIZE) {
+            dropped_events = head_log_seq - EVENT_LOG_SIZE - last_log_seq;
+            last_log_seq = head_log_seq - EVENT_LOG_SIZE;
+        }
+
+        eventlog_table _eventlog(orchestrator_, org.value);
+        while (last_log_seq < head_log_seq && events.size() < max_events) {
+            last_log_seq++;
+            auto eventlog_itr = _eventlog.find(last_log_seq % EVENT_LOG_SIZE);
+            if (eventlog_itr != _eventlog.end() && eventlog_itr->log_seq == last_log_seq) {
+                events.push_back(*eventlog_itr);
+            } else {
+                dropped_events++;
+            }
+        }
+
+        if (logcursor_itr == _logcursor.end()) {
+            _logcursor.emplace(self_, [&](auto& row) {
+                row.org = org;
+                row.last_log_seq = last_log_seq;
+                row.head_log_seq = head_log_seq;
+                row.dropped_events = dropped_events;
+            });
+        } else {
+            _logcursor.modify(logcursor_itr, self_, [&](auto& row) {
+                row.last_log_seq = last_log_seq;
+                row.head_log_seq = head_log_seq;
+                row.dropped_events += dropped_events;
+            });
+        }
+        return events;
+    }
+
+    /**
+     * Entries after log_seq up to head_log_seq still in the ring, the cursor is not moved.
+     */
+    std::vector<eventlog> pending(eosio::name org, uint64_t log_seq, uint64_t head_log_seq) {
+        std::vector<eventlog> events;
+        eventlog_table _eventlog(orchestrator_, org.value);
+        while (log_seq < head_log_seq) {
+            log_seq++;
+            auto eventlog_itr = _eventlog.find(log_seq % EVENT_LOG_SIZE);
+            if (eventlog_itr != _eventlog.end() && eventlog_itr->log_seq == log_seq) {
+                events.push_back(*eventlog_itr);
+            }
+        }
+        return events;
+    }
+
+    /**
+     * The org log carries every badge with a pull consumer, keep only badges
+     * that list this contract. followed_badges caches the answer per badge.
+     */
+    bool follows_badge(eosio::name org, const eosio::symbol& badge_symbol, std::map<uint64_t, bool>& followed_badges) {
+        auto followed_itr = followed_badges.find(badge_symbol.code().raw());
+        if (followed_itr != followed_badges.end()) {
+            return followed_itr->second;
+        }
+        badge_table _badge(orchestrator_, org.value);
+        auto badge_itr = _badge.find(badge_symbol.code().raw());
+        bool follows = badge_itr != _badge.end() &&
+            std::find(badge_itr->notify_accounts.begin(), badge_itr->notify_accounts.end(), self_) != badge_itr->notify_accounts.end();
+        followed_badges.emplace(badge_symbol.code().raw(), follows);
+        return follows;
+    }
+
+private:
+    eosio::name self_;
+    eosio::name orchestrator_;
+};
+
+#endif // !defined(EVENTLOG_HPP)
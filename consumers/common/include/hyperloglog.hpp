@@ -0,0 +1,720 @@
+#if !defined(HYPERLOGLOG_HPP)
+#define HYPERLOGLOG_HPP
+
+/**
+ * @file hyperloglog.hpp
+ * @brief HyperLogLog cardinality estimator shared by the hll consumers
+ * @date Created 2013/3/20
+ * @author Hideaki Ohno
+ *
+ * The bit width is a template parameter, so register count and alpha are
+ * compile time constants. HyperLogLog does not own its registers, it works
+ * in place over one byte per register. PackedHyperLogLog works in place
+ * over a row's stored bytes in a sparse or 6-bit packed encoding.
+ */
+
+#include <array>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "murmur3.h"
+
+#define HLL_HASH_SEED 313
+
+#if defined(__has_builtin) && (defined(__GNUC__) || defined(__clang__))
+
+#define _GET_CLZ(x, b) (uint8_t)std::min(b, ::__builtin_clz(x)) + 1
+
+#else
+
+inline uint8_t _get_leading_zero_count(uint32_t x, uint8_t b) {
+
+#if defined (_MSC_VER)
+    uint32_t leading_zero_len = 32;
+    ::_BitScanReverse(&leading_zero_len, x);
+    --leading_zero_len;
+    return std::min(b, (uint8_t)leading_zero_len);
+#else
+    uint8_t v = 1;
+    while (v <= b && !(x & 0x80000000)) {
+        v++;
+        x <<= 1;
+    }
+    return v;
+#endif
+
+}
+#define _GET_CLZ(x, b) _get_leading_zero_count(x, b)
+#endif /* defined(__GNUC__) */
+
+namespace hll {
+
+static const double pow_2_32 = 4294967296.0; ///< 2^32
+static const double neg_pow_2_32 = -4294967296.0; ///< -(2^32)
+static const uint64_t ln_2_q16 = 45426; ///< ln(2) in Q16.16
+
+/**
+ * Base 2 logarithm in Q16.16 fixed point, integer only.
+ *
+ * @param[in] x value, must be greater than 0
+ * @return log2(x) * 2^16
+ */
+inline uint64_t log2_q16(uint64_t x) {
+    uint64_t int_part = 63 - ::__builtin_clzll(x);
+    // normalize x into [1, 2) as Q32 and square it once per fractional bit
+    uint64_t y = (int_part >= 32) ? (x >> (int_part - 32)) : (x << (32 - int_part));
+    uint64_t frac = 0;
+    for (uint32_t i = 0; i < 16; i++) {
+        y = static_cast<uint64_t>((static_cast<unsigned __int128>(y) * y) >> 32);
+        frac <<= 1;
+        if (y >= (uint64_t(2) << 32)) {
+            y >>= 1;
+            frac |= 1;
+        }
+    }
+    return (int_part << 16) | frac;
+}
+
+/**
+ * 64-bit finalizer of splitmix64, full avalanche over the input bits.
+ *
+ * @param[in] x value to mix
+ * @return mixed value
+ */
+inline uint64_t mix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL * HLL_HASH_SEED;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Writes the characters of an account name, as name::to_string() does.
+ *
+ * @param[in] value raw name value
+ * @param[out] out at least 13 chars, not terminated
+ * @return number of characters written
+ */
+inline uint32_t name_chars(uint64_t value, char* out) {
+    static const char* charmap = ".12345abcdefghijklmnopqrstuvwxyz";
+    uint64_t tmp = value;
+    for (uint32_t i = 0; i <= 12; ++i) {
+        out[12 - i] = charmap[tmp & (i == 0 ? 0x0f : 0x1f)];
+        tmp >>= (i == 0 ? 4 : 5);
+    }
+    uint32_t len = 13;
+    while (len > 0 && out[len - 1] == '.') {
+        len--;
+    }
+    return len;
+}
+
+/**
+ * Register an element maps to and the rank it would store there.
+ */
+struct position {
+    uint32_t index;
+    uint8_t rank;
+};
+
+static const uint8_t hash_murmur_string = 0; ///< murmur3 over the name characters
+static const uint8_t hash_mix64 = 1; ///< mix64 over the raw name value
+static const uint8_t current_hash_version = hash_mix64;
+
+/** @class HyperLogLog
+ *  @brief Implement of 'HyperLogLog' estimate cardinality algorithm
+ *
+ *  @tparam B bit width (register count is 2 to the B power), in the range [4,16].
+ */
+template <uint8_t B>
+class HyperLogLog {
+    static_assert(B >= 4 && B <= 16, "bit width must be in the range [4,16]");
+
+public:
+    static constexpr uint32_t register_count = uint32_t(1) << B;
+
+    static constexpr double alpha =
+        register_count == 16 ? 0.673 :
+        register_count == 32 ? 0.697 :
+        register_count == 64 ? 0.709 :
+        0.7213 / (1.0 + 1.079 / register_count);
+
+    static constexpr double alpha_mm = alpha * register_count * register_count; ///< alpha * m^2
+
+    static constexpr uint64_t alpha_q16 =
+        register_count == 16 ? 44106 :
+        register_count == 32 ? 45679 :
+        register_count == 64 ? 46465 :
+        // 0.7213 / (1 + 1.079 / m) = 0.7213 * m / (m + 1.079)
+        (uint64_t(47270) * register_count * 1000) / (uint64_t(register_count) * 1000 + 1079);
+
+    /**
+     * Works in place over registers, which must hold register_count bytes.
+     *
+     * @param[in,out] registers register bytes, usually those of a table row
+     */
+    explicit HyperLogLog(uint8_t* registers) : M_(registers) {}
+
+    /**
+     * Works in place over a row's register vector, sizing it if the row
+     * has no registers yet. Rows of the right size are not reallocated.
+     *
+     * @param[in,out] registers register vector of a table row
+     */
+    explicit HyperLogLog(std::vector<uint8_t>& registers) : M_(nullptr) {
+        if (registers.size() != register_count) {
+            registers.resize(register_count, 0);
+        }
+        M_ = registers.data();
+    }
+
+    /**
+     * Hashes an element to the register it maps to.
+     *
+     * @param[in] str string to hash
+     * @param[in] len length of string
+     * @return register index and rank
+     */
+    static position locate(const char* str, uint32_t len) {
+        uint32_t hash;
+        MurmurHash3_x86_32(str, len, HLL_HASH_SEED, (void*) &hash);
+        return locate_hash(hash);
+    }
+
+    /**
+     * Splits a 32-bit hash into register index and rank.
+     *
+     * @param[in] hash hash of an element
+     * @return register index and rank
+     */
+    static position locate_hash(uint32_t hash) {
+        return position {
+            .index = hash >> (32 - B),
+            .rank = static_cast<uint8_t>(_GET_CLZ((hash << B), 32 - B))
+        };
+    }
+
+    /**
+     * Whether adding the element at pos would change stored registers.
+     * Lets callers skip the row write for senders already seen.
+     *
+     * @param[in] registers stored registers, possibly empty
+     * @param[in] pos result of locate()
+     */
+    static bool raises(const std::vector<uint8_t>& registers, const position& pos) {
+        return registers.size() != register_count || registers[pos.index] < pos.rank;
+    }
+
+    /**
+     * Adds a located element to the estimator
+     *
+     * @param[in] pos result of locate()
+     * @return true if a register changed, i.e. the element was not seen before
+     */
+    bool add(const position& pos) {
+        if (pos.rank > M_[pos.index]) {
+            M_[pos.index] = pos.rank;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * Adds element to the estimator
+     *
+     * @param[in] str string to add
+     * @param[in] len length of string
+     * @return true if a register changed, i.e. the element was not seen before
+     */
+    bool add(const char* str, uint32_t len) {
+        return add(locate(str, len));
+    }
+
+    /**
+     * Estimates cardinality value.
+     *
+     * @param[in] M register_count register bytes
+     * @return Estimated cardinality value.
+     */
+    static double estimate(const uint8_t* M) {
+        double estimate;
+        double sum = 0.0;
+        for (uint32_t i = 0; i < register_count; i++) {
+            sum += 1.0 / (1 << M[i]);
+        }
+        estimate = alpha_mm / sum; // E in the original paper
+        if (estimate <= 2.5 * register_count) {
+            uint32_t zeros = 0;
+            for (uint32_t i = 0; i < register_count; i++) {
+                if (M[i] == 0) {
+                    zeros++;
+                }
+            }
+            if (zeros != 0) {
+                estimate = register_count * std::log(static_cast<double>(register_count) / zeros);
+            }
+        } else if (estimate > (1.0 / 30.0) * pow_2_32) {
+            estimate = neg_pow_2_32 * log(1.0 - (estimate / pow_2_32));
+        }
+        return estimate;
+    }
+
+    double estimate() const {
+        return estimate(M_);
+    }
+
+    /**
+     * Estimates cardinality value without floating point.
+     * Same formula as estimate() including the small range correction,
+     * the large range correction is not applied.
+     *
+     * @param[in] M register_count register bytes
+     * @return Estimated cardinality value, rounded down.
+     */
+    static uint64_t estimate_int(const uint8_t* M) {
+        // sum of 2^-M[i] in Q32, alpha in Q16
+        uint64_t sum_q32 = 0;
+        uint32_t zeros = 0;
+        for (uint32_t i = 0; i < register_count; i++) {
+            sum_q32 += uint64_t(1) << (32 - M[i]);
+            if (M[i] == 0) {
+                zeros++;
+            }
+        }
+        unsigned __int128 alpha_mm_q48 = static_cast<unsigned __int128>(alpha_q16 * register_count) * register_count << 32;
+        uint64_t estimate = static_cast<uint64_t>(alpha_mm_q48 / sum_q32 >> 16);
+        if (estimate <= (uint64_t(5) * register_count) / 2 && zeros != 0) {
+            // m * ln(m / zeros)
+            uint64_t ln_q16 = ((log2_q16(register_count) - log2_q16(zeros)) * ln_2_q16) >> 16;
+            estimate = (uint64_t(register_count) * ln_q16) >> 16;
+        }
+        return estimate;
+    }
+
+    uint64_t estimate_int() const {
+        return estimate_int(M_);
+    }
+
+    /**
+     * Merges other registers into this object, which then estimates their union.
+     *
+     * @param[in] other register_count register bytes
+     */
+    void merge(const uint8_t* other) {
+        // fixed trip count and no branches, compiles to wide byte max
+        for (uint32_t r = 0; r < register_count; ++r) {
+            M_[r] = std::max(M_[r], other[r]);
+        }
+    }
+
+    void merge(const HyperLogLog& other) {
+        merge(other.M_);
+    }
+
+    /**
+     * Clears all internal registers.
+     */
+    void clear() {
+        std::fill(M_, M_ + register_count, 0);
+    }
+
+    /**
+     * Returns size of register.
+     *
+     * @return Register size
+     */
+    static constexpr uint32_t registerSize() {
+        return register_count;
+    }
+
+    const uint8_t* registers() const {
+        return M_;
+    }
+
+private:
+    uint8_t* M_; ///< registers, not owned
+};
+
+/** @class name_element
+ *  @brief An account name to add, located under either hash version.
+ *  The name characters are only decoded and hashed for rows of the string hash.
+ */
+template <uint8_t B>
+class name_element {
+public:
+    explicit name_element(uint64_t value) : value_(value), string_located_(false) {}
+
+    position at(uint8_t hash_version) {
+        if (hash_version == hash_mix64) {
+            return HyperLogLog<B>::locate_hash(static_cast<uint32_t>(mix64(value_) >> 32));
+        }
+        if (!string_located_) {
+            char chars[13];
+            uint32_t len = name_chars(value_, chars);
+            string_pos_ = HyperLogLog<B>::locate(chars, len);
+            string_located_ = true;
+        }
+        return string_pos_;
+    }
+
+private:
+    uint64_t value_;
+    bool string_located_;
+    position string_pos_;
+};
+
+/** @class PackedHyperLogLog
+ *  @brief HyperLogLog over the compact encodings stored in table rows
+ *
+ *  Stored bytes are read by size and leading tag:
+ *  - empty: no element added yet
+ *  - register_count bytes: one byte per register, as written before packing
+ *  - sparse tag, then sorted uint16 entries (index << 5 | rank), little endian
+ *  - packed tag, then 6 bits per register, little endian bit order
+ *
+ *  The low nibble of a tag is the encoding, the high nibble the hash version.
+ *  A row keeps the hash it was started with, new rows use current_hash_version.
+ *  Rows start sparse and are promoted to packed once sparse would be larger,
+ *  or are packed up front with pack().
+ *  Rows of one byte per register are repacked on their next write.
+ *
+ *  @tparam B bit width, in the range [4,11] so an entry fits in 16 bits.
+ */
+template <uint8_t B>
+class PackedHyperLogLog {
+    static_assert(B >= 4 && B <= 11, "bit width must be in the range [4,11]");
+
+public:
+    typedef HyperLogLog<B> dense_hll;
+    typedef name_element<B> element;
+    typedef std::array<uint8_t, dense_hll::register_count> dense_registers;
+
+    static constexpr uint32_t register_count = dense_hll::register_count;
+    static constexpr uint8_t sparse_encoding = 1;
+    static constexpr uint8_t packed_encoding = 2;
+    static constexpr uint32_t packed_size = 1 + (register_count * 6 + 7) / 8;
+    static constexpr uint32_t sparse_limit = (packed_size - 1) / 2; ///< entries before promotion
+
+    /**
+     * Works in place over a row's stored bytes, in any encoding.
+     *
+     * @param[in,out] stored register bytes of a table row
+     */
+    explicit PackedHyperLogLog(std::vector<uint8_t>& stored) : S_(stored) {}
+
+    /**
+     * Hash version elements must be located with for this row.
+     *
+     * @param[in] stored register bytes in any encoding
+     */
+    static uint8_t hash_version(const std::vector<uint8_t>& stored) {
+        if (stored.empty()) {
+            return current_hash_version;
+        }
+        if (stored.size() == register_count) {
+            return hash_murmur_string;
+        }
+        return stored[0] >> 4;
+    }
+
+    /**
+     * Reads one register without decoding the others.
+     *
+     * @param[in] stored register bytes in any encoding
+     * @param[in] index register index
+     * @return register value
+     */
+    static uint8_t get(const std::vector<uint8_t>& stored, uint32_t index) {
+        if (stored.empty()) {
+            return 0;
+        }
+        if (stored.size() == register_count) {
+            return stored[index];
+        }
+        if (encoding(stored) == packed_encoding) {
+            return get_packed(stored.data() + 1, index);
+        }
+        uint32_t count = (stored.size() - 1) / 2;
+        uint32_t pos = sparse_lower_bound(stored, index);
+        if (pos < count && sparse_entry(stored, pos) >> 5 == index) {
+            return sparse_entry(stored, pos) & 0x1f;
+        }
+        return 0;
+    }
+
+    /**
+     * Whether adding the element at pos would change stored registers.
+     * Lets callers skip the row write for senders already seen.
+     *
+     * @param[in] stored register bytes in any encoding
+     * @param[in] pos element located with hash_version(stored)
+     */
+    static bool raises(const std::vector<uint8_t>& stored, const position& pos) {
+        return get(stored, pos.index) < pos.rank;
+    }
+
+    static bool raises(const std::vector<uint8_t>& stored, element& e) {
+        return raises(stored, e.at(hash_version(stored)));
+    }
+
+    /**
+     * Adds a located element to the estimator
+     *
+     * @param[in] pos element located with hash_version() of this row
+     * @return true if a register changed, i.e. the element was not seen before
+     */
+    bool add(const position& pos) {
+        if (S_.size() == register_count) {
+            if (S_[pos.index] >= pos.rank) {
+                return false;
+            }
+            dense_registers M;
+            std::copy(S_.begin(), S_.end(), M.begin());
+            M[pos.index] = pos.rank;
+            store_packed(M.data(), hash_murmur_string);
+            return true;
+        }
+        if (!S_.empty() && encoding(S_) == packed_encoding) {
+            if (get_packed(S_.data() + 1, pos.index) >= pos.rank) {
+                return false;
+            }
+            set_packed(S_.data() + 1, pos.index, pos.rank);
+            return true;
+        }
+        if (S_.empty()) {
+            S_.push_back(tag(current_hash_version, sparse_encoding));
+        }
+        uint32_t count = (S_.size() - 1) / 2;
+        uint32_t at = sparse_lower_bound(S_, pos.index);
+        uint16_t entry = static_cast<uint16_t>(pos.index << 5 | pos.rank);
+        if (at < count && sparse_entry(S_, at) >> 5 == pos.index) {
+            if ((sparse_entry(S_, at) & 0x1f) >= pos.rank) {
+                return false;
+            }
+            S_[1 + at * 2] = entry & 0xff;
+            S_[2 + at * 2] = entry >> 8;
+            return true;
+        }
+        if (count + 1 > sparse_limit) {
+            dense_registers M;
+            decode(S_, M.data());
+            M[pos.index] = pos.rank;
+            store_packed(M.data(), hash_version(S_));
+            return true;
+        }
+        uint8_t bytes[2] = {static_cast<uint8_t>(entry & 0xff), static_cast<uint8_t>(entry >> 8)};
+        S_.insert(S_.begin() + 1 + at * 2, bytes, bytes + 2);
+        return true;
+    }
+
+    /**
+     * Converts the row to the packed encoding, keeping its hash version.
+     * Rows expected to outgrow sparse call it before adding, so that add
+     * updates registers in place instead of inserting sparse entries.
+     */
+    void pack() {
+        if (!S_.empty() && S_.size() != register_count && encoding(S_) == packed_encoding) {
+            return;
+        }
+        dense_registers M;
+        decode(S_, M.data());
+        store_packed(M.data(), hash_version(S_));
+    }
+
+    /**
+     * Adds an account name with the hash of this row.
+     *
+     * @param[in] e name to add
+     * @return true if a register changed, i.e. the name was not seen before
+     */
+    bool add(element& e) {
+        return add(e.at(hash_version(S_)));
+    }
+
+    /**
+     * Expands stored bytes to one byte per register.
+     *
+     * @param[in] stored register bytes in any encoding
+     * @param[out] M register_count bytes
+     */
+    static void decode(const std::vector<uint8_t>& stored, uint8_t* M) {
+        if (stored.size() == register_count) {
+            std::copy(stored.begin(), stored.end(), M);
+            return;
+        }
+        std::fill(M, M + register_count, 0);
+        if (stored.empty()) {
+            return;
+        }
+        if (encoding(stored) == packed_encoding) {
+            for (uint32_t i = 0; i < register_count; i++) {
+                M[i] = get_packed(stored.data() + 1, i);
+            }
+            return;
+        }
+        uint32_t count = (stored.size() - 1) / 2;
+        for (uint32_t i = 0; i < count; i++) {
+            uint16_t entry = sparse_entry(stored, i);
+            M[entry >> 5] = entry & 0x1f;
+        }
+    }
+
+    static double estimate(const std::vector<uint8_t>& stored) {
+        dense_registers M;
+        decode(stored, M.data());
+        return dense_hll::estimate(M.data());
+    }
+
+    double estimate() const {
+        return estimate(S_);
+    }
+
+    static uint64_t estimate_int(const std::vector<uint8_t>& stored) {
+        dense_registers M;
+        decode(stored, M.data());
+        return dense_hll::estimate_int(M.data());
+    }
+
+    uint64_t estimate_int() const {
+        return estimate_int(S_);
+    }
+
+    /**
+     * Merges other stored registers into this object, which then estimates their union.
+     * Rows of different hash versions count an element present in both twice.
+     *
+     * @param[in] other register bytes in any encoding
+     */
+    void merge(const std::vector<uint8_t>& other) {
+        if (other.empty()) {
+            return;
+        }
+        if (S_.empty()) {
+            S_ = other;
+            return;
+        }
+        if (other.size() != register_count && encoding(other) == sparse_encoding) {
+            uint32_t count = (other.size() - 1) / 2;
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t entry = sparse_entry(other, i);
+                add(position {.index = uint32_t(entry >> 5), .rank = uint8_t(entry & 0x1f)});
+            }
+            return;
+        }
+        dense_registers M;
+        dense_registers O;
+        decode(S_, M.data());
+        decode(other, O.data());
+        dense_hll(M.data()).merge(O.data());
+        store_packed(M.data(), hash_version(S_));
+    }
+
+    void merge(const PackedHyperLogLog& other) {
+        merge(other.S_);
+    }
+
+    /**
+     * Merges stored registers into register_count bytes with a byte-wise max,
+     * for unions over many rows that are estimated once at the end.
+     *
+     * @param[in] stored register bytes in any encoding
+     * @param[in,out] M register_count bytes
+     */
+    static void merge_into(const std::vector<uint8_t>& stored, uint8_t* M) {
+        if (stored.empty()) {
+            return;
+        }
+        if (stored.size() != register_count && encoding(stored) == sparse_encoding) {
+            uint32_t count = (stored.size() - 1) / 2;
+            for (uint32_t i = 0; i < count; i++) {
+                uint16_t entry = sparse_entry(stored, i);
+                M[entry >> 5] = std::max(M[entry >> 5], uint8_t(entry & 0x1f));
+            }
+            return;
+        }
+        if (stored.size() == register_count) {
+            dense_hll(M).merge(stored.data());
+            return;
+        }
+        dense_registers O;
+        decode(stored, O.data());
+        dense_hll(M).merge(O.data());
+    }
+
+    /**
+     * Clears all internal registers, the row is restarted with the current hash.
+     */
+    void clear() {
+        S_.clear();
+    }
+
+    static constexpr uint32_t registerSize() {
+        return register_count;
+    }
+
+private:
+    static constexpr uint8_t tag(uint8_t hash_version, uint8_t encoding) {
+        return static_cast<uint8_t>(hash_version << 4 | encoding);
+    }
+
+    // encoding of a non empty row that is not one byte per register
+    static uint8_t encoding(const std::vector<uint8_t>& stored) {
+        return stored[0] & 0x0f;
+    }
+
+    static uint8_t get_packed(const uint8_t* data, uint32_t index) {
+        uint32_t bit = index * 6;
+        uint32_t byte = bit >> 3;
+        uint32_t shift = bit & 7;
+        uint32_t word = data[byte];
+        if (shift > 2) {
+            word |= uint32_t(data[byte + 1]) << 8;
+        }
+        return (word >> shift) & 0x3f;
+    }
+
+    static void set_packed(uint8_t* data, uint32_t index, uint8_t value) {
+        uint32_t bit = index * 6;
+        uint32_t byte = bit >> 3;
+        uint32_t shift = bit & 7;
+        uint32_t mask = uint32_t(0x3f) << shift;
+        uint32_t bits = uint32_t(value & 0x3f) << shift;
+        data[byte] = (data[byte] & ~mask) | (bits & 0xff);
+        if (shift > 2) {
+            data[byte + 1] = (data[byte + 1] & ~(mask >> 8)) | (bits >> 8);
+        }
+    }
+
+    static uint16_t sparse_entry(const std::vector<uint8_t>& stored, uint32_t pos) {
+        return uint16_t(stored[1 + pos * 2]) | uint16_t(stored[2 + pos * 2]) << 8;
+    }
+
+    // first sparse entry whose register index is not less than index
+    static uint32_t sparse_lower_bound(const std::vector<uint8_t>& stored, uint32_t index) {
+        uint32_t lo = 0;
+        uint32_t hi = (stored.size() - 1) / 2;
+        while (lo < hi) {
+            uint32_t mid = (lo + hi) / 2;
+            if (sparse_entry(stored, mid) >> 5 < index) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return lo;
+    }
+
+    void store_packed(const uint8_t* M, uint8_t hash_version) {
+        S_.assign(packed_size, 0);
+        S_[0] = tag(hash_version, packed_encoding);
+        for (uint32_t i = 0; i < register_count; i++) {
+            set_packed(S_.data() + 1, i, M[i]);
+        }
+    }
+
+    std::vector<uint8_t>& S_; ///< stored bytes, not owned
+};
+
+} // namespace hll
+
+#endif // !defined(HYPERLOGLOG_HPP)
@@ -0,0 +1,349 @@
+#if !defined(LEADERBOARD_HPP)
+#define LEADERBOARD_HPP
+
+/**
+ * @file leaderboard.hpp
+ * @brief Order-statistic leaderboard over a counted B+ tree of table rows
+ *
+ * Accounts are ordered by balance, highest first, ties by account name.
+ * Leaves hold up to LEADERBOARD_LEAF_CAP entries and internal nodes up to
+ * LEADERBOARD_NODE_CAP children with the entry count of each subtree, so
+ * update, rank of a balance and lookup by rank read and write one node per
+ * level. No row grows with the number of accounts sharing a balance.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+
+#define LEADERBOARD_LEAF_CAP 64
+#define LEADERBOARD_NODE_CAP 64
+
+struct rankentry {
+    eosio::name account;
+    uint64_t balance;
+};
+
+// first key of a subtree, entries before it route to the previous child
+struct rankchild {
+    uint64_t balance;
+    eosio::name account;
+    uint64_t node_id;
+    uint64_t count;
+};
+
+// scoped like the ranks table it replaces
+TABLE ranknode {
+    uint64_t id;
+    uint8_t level;                       // 0 for leaves
+    std::vector<rankentry> entries;      // leaves, in leaderboard order
+    std::vector<rankchild> children;     // internal nodes, in leaderboard order
+    uint64_t primary_key() const { return id; }
+};
+typedef eosio::multi_index<"ranknodes"_n, ranknode> ranknode_table;
+
+TABLE rankmeta {
+    uint64_t root_id;       // 0 while empty
+    uint64_t next_id = 1;
+    uint64_t accounts;
+};
+typedef eosio::singleton<"rankmeta"_n, rankmeta> rankmeta_table;
+
+class leaderboard {
+public:
+    leaderboard(eosio::name code, uint64_t scope) : nodes_(code, scope), meta_(code, scope) {}
+
+    /**
+     * Adds account at balance, nothing is done if it is already there.
+     */
+    void insert(eosio::name account, uint64_t balance, eosio::name payer) {
+        rankmeta meta = meta_.get_or_default();
+        if (meta.root_id == 0) {
+            meta.root_id = meta.next_id++;
+            nodes_.emplace(payer, [&](auto& row) {
+                row.id = meta.root_id;
+                row.level = 0;
+                row.entries.push_back(rankentry{account, balance});
+            });
+            meta.accounts = 1;
+            meta_.set(meta, payer);
+            return;
+        }
+
+        std::vector<std::pair<uint64_t, size_t>> path;
+        auto node_itr = nodes_.find(meta.root_id);
+        while (node_itr->level > 0) {
+            size_t pos = route(node_itr->children, balance, account);
+            path.push_back({node_itr->id, pos});
+            node_itr = nodes_.find(node_itr->children[pos].node_id);
+        }
+
+        std::vector<rankentry> entries = node_itr->entries;
+        auto at = std::lower_bound(entries.begin(), entries.end(), rankentry{account, balance}, entry_before);
+        if (at != entries.end() && at->account == account && at->balance == balance) {
+            return;
+        }
+        entries.insert(at, rankentry{account, balance});
+
+        // a split below hands its new right sibling to the parent
+        bool split = entries.size() > LEADERBOARD_LEAF_CAP;
+        rankchild right;
+        if (split) {
+            right = split_leaf(entries, meta, payer);
+        }
+        uint64_t left_count = entries.size();
+        nodes_.modify(node_itr, payer, [&](auto& row) {
+            row.entries = entries;
+        });
+
+        for (auto path_itr = path.rbegin(); path_itr != path.rend(); path_itr++) {
+            auto parent_itr = nodes_.find(path_itr->first);
+            size_t pos = path_itr->second;
+            std::vector<rankchild> children = parent_itr->children;
+            rankchild& child = children[pos];
+            if (key_before(balance, account, child.balance, child.account)) {
+                child.balance = balance;
+                child.account = account;
+            }
+            if (split) {
+                child.count = left_count;
+                children.insert(children.begin() + pos + 1, right);
+            } else {
+                child.count++;
+            }
+            split = children.size() > LEADERBOARD_NODE_CAP;
+            if (split) {
+                right = split_node(children, parent_itr->level, meta, payer);
+                left_count = 0;
+                for (auto& left : children) {
+                    left_count += left.count;
+                }
+            }
+            nodes_.modify(parent_itr, payer, [&](auto& row) {
+                row.children = children;
+            });
+        }
+
+        if (split) {
+            // the root split, grow the tree by one level
+            auto root_itr = nodes_.find(meta.root_id);
+            rankchild left{root_itr->level == 0 ? root_itr->entries[0].balance : root_itr->children[0].balance,
+                           root_itr->level == 0 ? root_itr->entries[0].account : root_itr->children[0].account,
+                           meta.root_id, left_count};
+            uint8_t level = root_itr->level + 1;
+            meta.root_id = meta.next_id++;
+            nodes_.emplace(payer, [&](auto& row) {
+                row.id = meta.root_id;
+                row.level = level;
+                row.children = {left, right};
+            });
+        }
+        meta.accounts++;
+        meta_.set(meta, payer);
+    }
+
+    /**
+     * Removes account at balance.
+     *
+     * @return false if account is not on the leaderboard at balance
+     */
+    bool remove(eosio::name account, uint64_t balance, eosio::name payer) {
+        rankmeta meta = meta_.get_or_default();
+        if (meta.root_id == 0) {
+            return false;
+        }
+
+        std::vector<std::pair<uint64_t, size_t>> path;
+        auto node_itr = nodes_.find(meta.root_id);
+        while (node_itr->level > 0) {
+            size_t pos = route(node_itr->children, balance, account);
+            path.push_back({node_itr->id, pos});
+            node_itr = nodes_.find(node_itr->children[pos].node_id);
+        }
+
+        auto& entries = node_itr->entries;
+        auto at = std::lower_bound(entries.begin(), entries.end(), rankentry{account, balance}, entry_before);
+        if (at == entries.end() || at->account != account || at->balance != balance) {
+            return false;
+        }
+        size_t at_pos = at - entries.begin();
+
+        // an emptied node is erased and dropped from its parent
+        bool emptied = entries.size() == 1;
+        if (emptied) {
+            nodes_.erase(node_itr);
+        } else {
+            nodes_.modify(node_itr, payer, [&](auto& row) {
+                row.entries.erase(row.entries.begin() + at_pos);
+            });
+        }
+
+        for (auto path_itr = path.rbegin(); path_itr != path.rend(); path_itr++) {
+            auto parent_itr = nodes_.find(path_itr->first);
+            size_t pos = path_itr->second;
+            if (emptied && parent_itr->children.size() == 1) {
+                nodes_.erase(parent_itr);
+                continue;
+            }
+            nodes_.modify(parent_itr, payer, [&](auto& row) {
+                if (emptied) {
+                    row.children.erase(row.children.begin() + pos);
+                } else {
+                    row.children[pos].count--;
+                }
+            });
+            emptied = false;
+        }
+
+        meta.accounts--;
+        if (emptied) {
+            meta.root_id = 0;
+        } else {
+            // an internal root left with one child is replaced by it
+            auto root_itr = nodes_.find(meta.root_id);
+            while (root_itr->level > 0 && root_itr->children.size() == 1) {
+                meta.root_id = root_itr->children[0].node_id;
+                nodes_.erase(root_itr);
+                root_itr = nodes_.find(meta.root_id);
+            }
+        }
+        meta_.set(meta, payer);
+        return true;
+    }
+
+    /**
+     * Competition rank of balance: 1 + accounts with a higher balance.
+     */
+    uint64_t rank_of(uint64_t balance) const {
+        rankmeta meta = meta_.get_or_default();
+        uint64_t before = 0;
+        if (meta.root_id == 0) {
+            return 1;
+        }
+        // the lowest account name sorts first among equal balances
+        eosio::name account = eosio::name(0);
+        auto node_itr = nodes_.find(meta.root_id);
+        while (node_itr->level > 0) {
+            size_t pos = route(node_itr->children, balance, account);
+            for (size_t i = 0; i < pos; i++) {
+                before += node_itr->children[i].count;
+            }
+            node_itr = nodes_.find(node_itr->children[pos].node_id);
+        }
+        auto& entries = node_itr->entries;
+        before += std::lower_bound(entries.begin(), entries.end(), rankentry{account, balance}, entry_before) - entries.begin();
+        return before + 1;
+    }
+
+    /**
+     * Up to count entries starting at 1-based position first, in leaderboard order.
+     */
+    std::vector<rankentry> range(uint64_t first, uint32_t count) const {
+        std::vector<rankentry> result;
+        rankmeta meta = meta_.get_or_default();
+        uint64_t position = first > 0 ? first - 1 : 0;
+        while (meta.root_id != 0 && result.size() < count && position < meta.accounts) {
+            // descend by subtree counts, then read the rest of the leaf
+            uint64_t offset = position;
+            auto node_itr = nodes_.find(meta.root_id);
+            while (node_itr->level > 0) {
+                size_t pos = 0;
+                while (pos + 1 < node_itr->children.size() && offset >= node_itr->children[pos].count) {
+                    offset -= node_itr->children[pos].count;
+                    pos++;
+                }
+                node_itr = nodes_.find(node_itr->children[pos].node_id);
+            }
+            if (offset >= node_itr->entries.size()) {
+                break;
+            }
+            for (size_t i = offset; i < node_itr->entries.size() && result.size() < count; i++) {
+                result.push_back(node_itr->entries[i]);
+                position++;
+            }
+        }
+        return result;
+    }
+
+    uint64_t accounts() const {
+        return meta_.get_or_default().accounts;
+    }
+
+    /**
+     * Erases up to max_nodes nodes, returns true once the leaderboard is gone.
+     * Only for a scope nothing ranks against any more, ranks read in between
+     * are meaningless.
+     */
+    bool clear(uint16_t max_nodes) {
+        auto node_itr = nodes_.begin();
+        for (uint16_t i = 0; i < max_nodes && node_itr != nodes_.end(); i++) {
+            node_itr = nodes_.erase(node_itr);
+        }
+        if (node_itr != nodes_.end()) {
+            return false;
+        }
+        // kept until the last node is gone so next_id cannot hand out an id still in use
+        if (meta_.exists()) {
+            meta_.remove();
+        }
+        return true;
+    }
+
+private:
+    static bool key_before(uint64_t a_balance, eosio::name a_account, uint64_t b_balance, eosio::name b_account) {
+        return a_balance > b_balance || (a_balance == b_balance && a_account < b_account);
+    }
+
+    static bool entry_before(const rankentry& a, const rankentry& b) {
+        return key_before(a.balance, a.account, b.balance, b.account);
+    }
+
+    // last child whose first key is not after the key, the first child for keys before all of them
+    static size_t route(const std::vector<rankchild>& children, uint64_t balance, eosio::name account) {
+        size_t lo = 1;
+        size_t hi = children.size();
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+            if (key_before(balance, account, children[mid].balance, children[mid].account)) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo - 1;
+    }
+
+    // moves the upper half of a full leaf into a new node
+    rankchild split_leaf(std::vector<rankentry>& entries, rankmeta& meta, eosio::name payer) {
+        std::vector<rankentry> upper(entries.begin() + LEADERBOARD_LEAF_CAP / 2, entries.end());
+        entries.resize(LEADERBOARD_LEAF_CAP / 2);
+        uint64_t id = meta.next_id++;
+        nodes_.emplace(payer, [&](auto& row) {
+            row.id = id;
+            row.level = 0;
+            row.entries = upper;
+        });
+        return rankchild{upper[0].balance, upper[0].account, id, upper.size()};
+    }
+
+    // moves the upper half of a full internal node into a new node
+    rankchild split_node(std::vector<rankchild>& children, uint8_t level, rankmeta& meta, eosio::name payer) {
+        std::vector<rankchild> upper(children.begin() + LEADERBOARD_NODE_CAP / 2, children.end());
+        children.resize(LEADERBOARD_NODE_CAP / 2);
+        uint64_t id = meta.next_id++;
+        uint64_t count = 0;
+        for (auto& child : upper) {
+            count += child.count;
+        }
+        nodes_.emplace(payer, [&](auto& row) {
+            row.id = id;
+            row.level = level;
+            row.children = upper;
+        });
+        return rankchild{upper[0].balance, upper[0].account, id, count};
+    }
+
+    ranknode_table nodes_;
+    rankmeta_table meta_;
+};
+
+#endif // !defined(LEADERBOARD_HPP)
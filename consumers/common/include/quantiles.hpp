@@ -0,0 +1,197 @@
+#if !defined(QUANTILES_HPP)
+#define QUANTILES_HPP
+
+/**
+ * @file quantiles.hpp
+ * @brief Mergeable integer quantile sketch of account balances
+ *
+ * Balances below 2^S are counted exactly. Each higher power of two range
+ * is split into 2^S equal buckets, so a reported quantile is within a
+ * factor 1 +- 2^-(S+1) of the true one. Unlike KLL or t-digest a bucket
+ * count can be decremented, which is what moving an account from its old
+ * balance to its new one needs. Sketches merge by adding counts.
+ *
+ * The sketch works in place over a row's counts, trailing empty buckets
+ * are not stored, so a row only grows with the highest balance.
+ * Log2Histogram is the fixed size, one bucket per power of two view.
+ */
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace quantile {
+
+/** @class LogLinearSketch
+ *  @brief Bucketed balance counts with bounded relative error
+ *
+ *  @tparam S sub-bucket bits per power of two, in [1, 8]
+ */
+template<uint8_t S>
+class LogLinearSketch {
+    static_assert(S >= 1 && S <= 8, "sub-bucket bits out of range");
+public:
+    static constexpr uint32_t sub_buckets = 1u << S;
+
+    LogLinearSketch(std::vector<uint32_t>& counts) : C_(counts) {}
+
+    /**
+     * Bucket of a value, exact below 2^S.
+     */
+    static uint32_t bucket(uint64_t value) {
+        if (value < sub_buckets) {
+            return (uint32_t)value;
+        }
+        uint32_t exponent = 63 - ::__builtin_clzll(value);
+        uint32_t sub = (uint32_t)(value >> (exponent - S)) & (sub_buckets - 1);
+        return ((exponent - S + 1) << S) + sub;
+    }
+
+    /**
+     * Smallest value of a bucket.
+     */
+    static uint64_t lower(uint32_t index) {
+        if (index < sub_buckets) {
+            return index;
+        }
+        uint32_t exponent = (index >> S) + S - 1;
+        uint64_t sub = index & (sub_buckets - 1);
+        return (sub_buckets | sub) << (exponent - S);
+    }
+
+    /**
+     * Midpoint of a bucket, the value reported for ranks that fall in it.
+     */
+    static uint64_t middle(uint32_t index) {
+        if (index < sub_buckets) {
+            return index;
+        }
+        uint32_t exponent = (index >> S) + S - 1;
+        uint64_t width = uint64_t(1) << (exponent - S);
+        return lower(index) + (width - 1) / 2;
+    }
+
+    /**
+     * Moves one account from old_value to new_value, 0 is no balance.
+     */
+    void move(uint64_t old_value, uint64_t new_value) {
+        if (old_value == new_value) {
+            return;
+        }
+        if (old_value > 0) {
+            uint32_t index = bucket(old_value);
+            if (index < C_.size() && C_[index] > 0) {
+                C_[index]--;
+            }
+        }
+        if (new_value > 0) {
+            uint32_t index = bucket(new_value);
+            if (index >= C_.size()) {
+                C_.resize(index + 1, 0);
+            }
+            C_[index]++;
+        }
+        while (!C_.empty() && C_.back() == 0) {
+            C_.pop_back();
+        }
+    }
+
+    void merge(const std::vector<uint32_t>& other) {
+        if (other.size() > C_.size()) {
+            C_.resize(other.size(), 0);
+        }
+        for (size_t i = 0; i < other.size(); i++) {
+            C_[i] += other[i];
+        }
+    }
+
+    static uint64_t total(const std::vector<uint32_t>& counts) {
+        uint64_t sum = 0;
+        for (auto count : counts) {
+            sum += count;
+        }
+        return sum;
+    }
+
+    /**
+     * Balance at the given quantile, nearest-rank.
+     *
+     * @param[in] counts stored bucket counts
+     * @param[in] permille quantile in thousandths, 500 for the median
+     * @return 0 if counts is empty
+     */
+    static uint64_t quantile(const std::vector<uint32_t>& counts, uint32_t permille) {
+        uint64_t n = total(counts);
+        if (n == 0) {
+            return 0;
+        }
+        uint64_t rank = (n * permille + 999) / 1000;
+        if (rank == 0) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (uint32_t i = 0; i < counts.size(); i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return middle(i);
+            }
+        }
+        return middle(counts.size() - 1);
+    }
+
+private:
+    std::vector<uint32_t>& C_;
+};
+
+/** @class Log2Histogram
+ *  @brief Holder counts per power of two of the balance
+ *
+ *  Bucket i counts balances in [2^i, 2^(i+1)), a row always has 64 buckets.
+ */
+class Log2Histogram {
+public:
+    static constexpr uint32_t bucket_count = 64;
+
+    Log2Histogram(std::vector<uint32_t>& counts) : C_(counts) {
+        C_.resize(bucket_count, 0);
+    }
+
+    static uint32_t bucket(uint64_t value) {
+        return 63 - ::__builtin_clzll(value);
+    }
+
+    /**
+     * Whether moving a balance from old_value to new_value changes any bucket, 0 is no balance.
+     */
+    static bool moves(uint64_t old_value, uint64_t new_value) {
+        if (old_value == 0 || new_value == 0) {
+            return old_value != new_value;
+        }
+        return bucket(old_value) != bucket(new_value);
+    }
+
+    void move(uint64_t old_value, uint64_t new_value) {
+        if (!moves(old_value, new_value)) {
+            return;
+        }
+        if (old_value > 0 && C_[bucket(old_value)] > 0) {
+            C_[bucket(old_value)]--;
+        }
+        if (new_value > 0) {
+            C_[bucket(new_value)]++;
+        }
+    }
+
+    void merge(const std::vector<uint32_t>& other) {
+        for (size_t i = 0; i < other.size() && i < bucket_count; i++) {
+            C_[i] += other[i];
+        }
+    }
+
+private:
+    std::vector<uint32_t>& C_;
+};
+
+} // namespace quantile
+
+#endif // !defined(QUANTILES_HPP)
@@ -0,0 +1,185 @@
+#if !defined(TOPHOLDERS_HPP)
+#define TOPHOLDERS_HPP
+
+/**
+ * @file topholders.hpp
+ * @brief Fixed capacity table of the highest balances of a scope
+ *
+ * Once the table is full its lowest balance is cached in topkmeta as the
+ * admission threshold. Balances only grow, so an account at or below the
+ * threshold cannot be a holder and costs one comparison and no writes;
+ * a higher one replaces the lowest holder.
+ *
+ * A scope that leaves top-K mode is marked restarted: its leaderboard was
+ * emptied while the holders stood in for it and only knows the accounts
+ * whose balance changed since.
+ */
+
+#include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
+#include <leaderboard.hpp>
+
+#define TOPHOLDERS_MAX_CAPACITY 1000
+
+// scoped like the leaderboard it stands in for
+TABLE topholder {
+    eosio::name account;
+    uint64_t balance;
+    uint64_t primary_key() const { return account.value; }
+    uint64_t by_balance() const { return balance; }
+};
+typedef eosio::multi_index<"topholders"_n, topholder,
+    eosio::indexed_by<"bybalance"_n, eosio::const_mem_fun<topholder, uint64_t, &topholder::by_balance>>
+> topholder_table;
+
+TABLE topkmeta {
+    uint16_t capacity;      // 0 while top-K mode is off
+    uint16_t size;
+    uint64_t threshold;     // lowest holder balance, only set once size reaches capacity
+    bool restarted;         // set once the scope left top-K mode
+};
+typedef eosio::singleton<"topkmeta"_n, topkmeta> topkmeta_table;
+
+class topholders {
+public:
+    topholders(eosio::name code, uint64_t scope) : holders_(code, scope), meta_(code, scope) {}
+
+    uint16_t capacity() const {
+        return meta_.get_or_default().capacity;
+    }
+
+    uint16_t size() const {
+        return meta_.get_or_default().size;
+    }
+
+    bool restarted() const {
+        return meta_.get_or_default().restarted;
+    }
+
+    void set_capacity(uint16_t capacity, eosio::name payer) {
+        topkmeta meta = meta_.get_or_default();
+        meta.capacity = capacity;
+        meta_.set(meta, payer);
+    }
+
+    /**
+     * Changes the capacity while in top-K mode. Shrinking drops the lowest
+     * holders; growing admits lower balances again from now on but cannot
+     * bring back accounts dropped before.
+     */
+    void resize(uint16_t capacity, eosio::name payer) {
+        topkmeta meta = meta_.get_or_default();
+        auto by_balance = holders_.get_index<"bybalance"_n>();
+        while (meta.size > capacity) {
+            by_balance.erase(by_balance.begin());
+            meta.size--;
+        }
+        meta.capacity = capacity;
+        if (meta.size > 0 && meta.size >= meta.capacity) {
+            meta.threshold = by_balance.begin()->balance;
+        }
+        meta_.set(meta, payer);
+    }
+
+    /**
+     * Turns top-K mode off, the holder rows stay until clear has erased them.
+     */
+    void leave(eosio::name payer) {
+        topkmeta meta = meta_.get_or_default();
+        meta.capacity = 0;
+        meta.restarted = true;
+        meta_.set(meta, payer);
+    }
+
+    /**
+     * Erases up to max_rows holders of a scope out of top-K mode, returns true once none is left.
+     */
+    bool clear(uint16_t max_rows, eosio::name payer) {
+        topkmeta meta = meta_.get_or_default();
+        eosio::check(meta.capacity == 0, "top-K holders still in use");
+        auto holder_itr = holders_.begin();
+        for (uint16_t i = 0; i < max_rows && holder_itr != holders_.end(); i++) {
+            holder_itr = holders_.erase(holder_itr);
+            meta.size--;
+        }
+        if (meta_.exists()) {
+            meta_.set(meta, payer);
+        }
+        return holder_itr == holders_.end();
+    }
+
+    /**
+     * Records account at balance if it is among the capacity highest.
+     */
+    void update(eosio::name account, uint64_t balance, eosio::name payer) {
+        topkmeta meta = meta_.get_or_default();
+        if (meta.size >= meta.capacity && balance <= meta.threshold) {
+            return;
+        }
+
+        auto holder_itr = holders_.find(account.value);
+        if (holder_itr != holders_.end()) {
+            holders_.modify(holder_itr, payer, [&](auto& row) {
+                row.balance = balance;
+            });
+        } else {
+            if (meta.size >= meta.capacity) {
+                auto by_balance = holders_.get_index<"bybalance"_n>();
+                by_balance.erase(by_balance.begin());
+            } else {
+                meta.size++;
+            }
+            holders_.emplace(payer, [&](auto& row) {
+                row.account = account;
+                row.balance = balance;
+            });
+        }
+
+        if (meta.size >= meta.capacity) {
+            auto by_balance = holders_.get_index<"bybalance"_n>();
+            meta.threshold = by_balance.begin()->balance;
+        }
+        meta_.set(meta, payer);
+    }
+
+    /**
+     * Competition rank of account among the holders, 0 if it is not one.
+     */
+    uint64_t rank_of(eosio::name account) const {
+        auto holder_itr = holders_.find(account.value);
+        if (holder_itr == holders_.end()) {
+            return 0;
+        }
+        auto by_balance = holders_.get_index<"bybalance"_n>();
+        uint64_t rank = 1;
+        for (auto itr = by_balance.upper_bound(holder_itr->balance); itr != by_balance.end(); itr++) {
+            rank++;
+        }
+        return rank;
+    }
+
+    /**
+     * Up to count holders starting at 1-based position first, in leaderboard order.
+     */
+    std::vector<rankentry> range(uint64_t first, uint32_t count) const {
+        std::vector<rankentry> holders;
+        for (auto& holder : holders_) {
+            holders.push_back(rankentry{holder.account, holder.balance});
+        }
+        std::sort(holders.begin(), holders.end(), [](const rankentry& a, const rankentry& b) {
+            return a.balance > b.balance || (a.balance == b.balance && a.account < b.account);
+        });
+
+        std::vector<rankentry> result;
+        for (uint64_t i = first > 0 ? first - 1 : 0; i < holders.size() && result.size() < count; i++) {
+            result.push_back(holders[i]);
+        }
+        return result;
+    }
+
+private:
+    topholder_table holders_;
+    topkmeta_table meta_;
+};
+
+#endif // !defined(TOPHOLDERS_HPP)
@@ -1,5 +1,6 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/crypto.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -10,11 +11,20 @@ using namespace eosio;
 
 
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
+#define NEW_BADGE_BATCH_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifybatch"
+#define NEW_BADGE_COMPACT_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachv2"
 
 
 CONTRACT cumulative : public contract {
 public:
   using contract::contract;
+
+  struct achievement_event {
+    asset badge_asset;
+    name from;
+    name to;
+    string memo;
+  };
   
   [[eosio::on_notify(NEW_BADGE_ISSUANCE_NOTIFICATION)]] void notifyachiev(
     name org,
@@ -24,6 +34,21 @@ public:
     string memo, 
     vector<name> notify_accounts);
 
+  [[eosio::on_notify(NEW_BADGE_BATCH_NOTIFICATION)]] void notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events);
+
+  [[eosio::on_notify(NEW_BADGE_COMPACT_NOTIFICATION)]] void notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash);
+
   ACTION dummy();
 
 private:
@@ -40,6 +65,23 @@ private:
   };
   typedef eosio::multi_index<"accounts"_n, account> accounts;
 
+  void add_balance(accounts& to_accounts, const asset& badge_asset) {
+    // Find the account using the amount's symbol code
+    auto existing_account = to_accounts.find(badge_asset.symbol.code().raw());
+
+    if (existing_account == to_accounts.end()) {
+      // If the account does not exist, create a new one with the specified badge_asset
+      to_accounts.emplace(get_self(), [&](auto& acc) {
+        acc.balance = badge_asset;
+      });
+    } else {
+      // If the account exists, modify its balance
+      to_accounts.modify(existing_account, get_self(), [&](auto& acc) {
+        acc.balance += badge_asset;
+      });
+    }
+  }
+
   void deduct_credit(name org, uint32_t bytes, string memo) {
     action{
       permission_level{get_self(), "active"_n},
@@ -59,5 +101,10 @@ private:
     uint8_t actions_used;
   };
 
+  struct billbulk_args {
+    name org;
+    uint64_t actions_used;
+  };
+
 };
 
@@ -4,20 +4,7 @@ void cumulative::notifyachiev(name org, asset badge_asset, name from, name to, s
     // Access the accounts table scoped by "to"
     accounts to_accounts(get_self(), to.value);
 
-    // Find the account using the amount's symbol code
-    auto existing_account = to_accounts.find(badge_asset.symbol.code().raw());
-
-    if (existing_account == to_accounts.end()) {
-        // If the account does not exist, create a new one with the specified badge_asset
-        to_accounts.emplace(get_self(), [&](auto& acc) {
-            acc.balance = badge_asset;
-        });
-    } else {
-        // If the account exists, modify its balance
-        to_accounts.modify(existing_account, get_self(), [&](auto& acc) {
-            acc.balance += badge_asset; // Assuming you want to add the badge_asset to the existing balance
-        });
-    }
+    add_balance(to_accounts, badge_asset);
     
     action {
         permission_level{get_self(), name("active")},
@@ -29,6 +16,56 @@ void cumulative::notifyachiev(name org, asset badge_asset, name from, name to, s
     }.send();
 }
 
+void cumulative::notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash) {
+    if (notify_account != get_self()) {
+        return;
+    }
+    // v2 events carry neither memo nor notify_accounts, neither is used here
+    notifyachiev(org, asset(amount, badge_symbol), from, to, "", {});
+}
+
+void cumulative::notifybatch(name org, name notify_account, std::vector<achievement_event> events) {
+    if (notify_account != get_self()) {
+        return;
+    }
+
+    // Group amounts by recipient so each accounts scope is opened once
+    std::map<name, std::map<uint64_t, asset>> recipient_totals;
+    for (auto& event : events) {
+        auto& totals = recipient_totals[event.to];
+        auto total_itr = totals.find(event.badge_asset.symbol.code().raw());
+        if (total_itr == totals.end()) {
+            totals.emplace(event.badge_asset.symbol.code().raw(), event.badge_asset);
+        } else {
+            total_itr->second += event.badge_asset;
+        }
+    }
+
+    for (auto& [to, totals] : recipient_totals) {
+        accounts to_accounts(get_self(), to.value);
+        for (auto& [badge_key, badge_asset] : totals) {
+            add_balance(to_accounts, badge_asset);
+        }
+    }
+
+    action {
+        permission_level{get_self(), name("active")},
+        name(SUBSCRIPTION_CONTRACT),
+        name("billbulk"),
+        billbulk_args {
+            .org = org,
+            .actions_used = events.size()}
+    }.send();
+}
+
 ACTION cumulative::dummy() {
     // created as a workaround for empty abi.
 }
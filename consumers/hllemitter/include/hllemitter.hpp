@@ -38,6 +38,9 @@ CONTRACT hllemitter : public contract {
     ACTION deactivate(name org, symbol badge_symbol);
 
   private:
+    // 2^7 registers per sender hll, stored sparse until promoted to 6-bit packed
+    typedef hll::PackedHyperLogLog<7> sender_hll;
+
     // scoped by contract
     TABLE auth {
       name action;
@@ -27,18 +27,12 @@ void hllemitter::notifyachiev(
     balances_table balances(_self, to.value);
 
     auto itr = balances.find(badge_asset.symbol.code().raw());
-    uint8_t b = 7;
-    uint32_t m = 1 << b;
+    sender_hll::element sender(from.value);
     if (itr == balances.end()) {
-        // Initialize HyperLogLog data structure
-        vector<uint8_t> M(m, 0);
-        hll::HyperLogLog hll(b, m, M);
-        hll.add(from.to_string().c_str(), from.to_string().size());
-
-        // No existing entry found, insert a new record
+        // No existing entry found, insert a new record with a fresh HyperLogLog
         balances.emplace(_self, [&](auto& row) {
             row.badge_symbol = badge_asset.symbol;
-            row.hll = hll.registers();
+            sender_hll(row.hll).add(sender);
         });
         for(auto i = 0; i < emit_assets.size(); i++) {
             name destination_org = get_org_from_badge_symbol(emit_assets[i].symbol, failure_identifier);
@@ -55,21 +49,10 @@ void hllemitter::notifyachiev(
         }
 
     } else {
-        bool increment = false;
-        
-        // Get existing HyperLogLog data
-        vector<uint8_t> M = itr->hll;
-        hll::HyperLogLog hll(b, m, M);
-        
-        // Estimate cardinality before and after adding new element
-        double estimate_before = hll.estimate();
-        hll.add(from.to_string().c_str(), from.to_string().size());
-        double estimate_after = hll.estimate();
-
-        // Check if cardinality has increased
-        if (estimate_before != estimate_after) {
+        // A register change means the sender was not seen before
+        if (sender_hll::raises(itr->hll, sender)) {
             balances.modify(itr, get_self(), [&](auto& row) {
-                row.hll = hll.registers();
+                sender_hll(row.hll).add(sender);
             });
             for(auto i = 0; i < emit_assets.size(); i++) {
                 name destination_org = get_org_from_badge_symbol(emit_assets[i].symbol, failure_identifier);
@@ -1,5 +1,7 @@
 #include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
 #include <hyperloglog.hpp>
+#include <scoring.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -35,6 +37,13 @@ CONTRACT rounds : public contract {
     ACTION pauseround (name org, name round);
     ACTION resumeround (name org, name round);
 
+    // routes every active round of org once, for orgs with rounds started before routes were kept.
+    // until then their issuances are scored from the scoremeta scan.
+    ACTION syncroutes (name org);
+
+    // advances the snapshot of an ended round by up to max_rows, repeat until it is done
+    ACTION finalize (name org, name round, uint16_t max_rows);
+
 
     ACTION addscoremeta (name org,
       name round, 
@@ -49,6 +58,8 @@ CONTRACT rounds : public contract {
 
 
   private:
+    // 2^7 registers per source hll, stored sparse until promoted to 6-bit packed
+    typedef hll::PackedHyperLogLog<7> source_hll;
 
     TABLE round {
       name round;
@@ -65,9 +76,9 @@ CONTRACT rounds : public contract {
       name round;
       uint64_t badge_id;
       name round_status_tentative; // ended, notended
-      name balance_based_scoring_type; // linear, fibo
+      name balance_based_scoring_type; // a scoring::curves type, or empty
       uint16_t balance_based_scoring_weight; 
-      name source_based_scoring_type; // linear, fibo
+      name source_based_scoring_type; // a scoring::curves type, or empty
       uint16_t source_based_scoring_weight;
       name badge_status; // active, pause
 
@@ -81,6 +92,30 @@ CONTRACT rounds : public contract {
     indexed_by<name("badgestatus"), const_mem_fun<scoremeta, uint128_t, &scoremeta::badge_round_status_key>>    
     > scoremeta_table; 
 
+    struct route {
+      uint64_t scoremeta_id;
+      name balance_based_scoring_type;
+      uint16_t balance_based_scoring_weight;
+      name source_based_scoring_type;
+      uint16_t source_based_scoring_weight;
+    };
+
+    // scoped by org, scoremeta rows of active rounds per badge with their scoring copied,
+    // so an issuance reads one row. rows are only written when a round changes status.
+    TABLE badgeroute {
+      uint64_t badge_id;
+      vector<route> routes;
+      auto primary_key() const {return badge_id; }
+    };
+    typedef multi_index<name("badgeroutes"), badgeroute> badgeroute_table;
+
+    // scoped by contract, orgs whose badgeroutes cover every active round
+    TABLE routedorg {
+      name org;
+      auto primary_key() const {return org.value; }
+    };
+    typedef multi_index<name("routedorgs"), routedorg> routedorg_table;
+
     TABLE scores {
       uint64_t score_id;
       uint64_t scoremeta_id;
@@ -99,155 +134,208 @@ CONTRACT rounds : public contract {
     indexed_by<name("scoreaccount"), const_mem_fun<scores, uint128_t, &scores::score_account_key>>    
     > scores_table; 
 
+    // scoped by org, one row per ended round while its snapshot is built and after.
+    // totals sums each account's scores over the round's scoremetas, ranking then
+    // drains totals from the highest score into the snapshot.
+    TABLE finalization {
+      name round;
+      uint64_t snapshot_id;
+      name phase; // totals, ranking, done
+      vector<uint64_t> scoremeta_ids;
+      uint32_t scoremeta_pos;
+      uint64_t account_cursor; // last account read in scoremeta_ids[scoremeta_pos], 0 before the first
+      uint64_t accounts;       // snapshot rows written
+      auto primary_key() const {return round.value; }
+    };
+    typedef multi_index<name("finalization"), finalization> finalization_table;
 
-  uint64_t quad(uint64_t n) {
-    return (n*n + n) / 2;
-  }
+    TABLE snapshotseq {
+      uint64_t last_snapshot_id;
+    };
+    typedef singleton<name("snapshotseq"), snapshotseq> snapshotseq_table;
 
-  uint64_t fib(uint64_t n) {
-    if (n <= 1)
-        return n;
-    return fib(n - 1) + fib(n - 2);
-  }
+    // scoped by snapshot_id, staging rows dropped as they are ranked
+    TABLE roundtotal {
+      name account;
+      uint64_t score;
+      auto primary_key() const {return account.value; }
 
-/*void balance_based_quadratic_score (name org, uint64_t scoremeta_id, name account, uint8_t count, uint64_t wt) {
-  scores_table _scores (get_self, org.value);
-    
-  auto score_account_index = _scores.get_index<name("scoreaccount")>();
-  uint128_t score_account_key = ((uint128_t) scoremeta_id) << 64 | account.value;
-  auto score_account_iterator = score_account_index.find (score_account_key);
-  
-
-  if (score_account_iterator == score_account_index.end()) {
-    uint64_t quad_num = quad (count); // optimize this.
-    _scores.emplace(get_self(), [&](auto& row){
-      row.id = _scores.available_primary_key();
-      row.scoremeta_id = scoremeta_id;
-      row.account = account;
-      row.score = quad_num * wt;
-      row.balance_count = count;
-    });  
-  }
-  else {
-    uint64_t quad_num = quad (count + score_account_iterator->balance_count); // optimize this.
-    score_account_index.modify(score_account_iterator, get_self, [&](auto& row) {
-      row.score = row.score + quad_num * wt;
-      row.balance_count = row.balance_count + count;
+      // highest score first, ties by account
+      uint128_t rank_order_key() const {
+        return ((uint128_t) ~score) << 64 | account.value;
+      }
+    };
+    typedef multi_index<name("roundtotals"), roundtotal,
+    indexed_by<name("rankorder"), const_mem_fun<roundtotal, uint128_t, &roundtotal::rank_order_key>>
+    > roundtotal_table;
+
+    // scoped by snapshot_id, position 1 is the highest score. rank is the competition
+    // rank, accounts with equal scores share the rank of the first of them.
+    TABLE snapshot {
+      uint64_t position;
+      name account;
+      uint64_t score;
+      uint64_t rank;
+      auto primary_key() const {return position; }
+      uint64_t by_account() const {return account.value; }
+    };
+    typedef multi_index<name("snapshot"), snapshot,
+    indexed_by<name("byaccount"), const_mem_fun<snapshot, uint64_t, &snapshot::by_account>>
+    > snapshot_table;
+
+
+  void add_route (badgeroute_table& _badgeroute, const scoremeta& meta) {
+    route entry {
+      .scoremeta_id = meta.scoremeta_id,
+      .balance_based_scoring_type = meta.balance_based_scoring_type,
+      .balance_based_scoring_weight = meta.balance_based_scoring_weight,
+      .source_based_scoring_type = meta.source_based_scoring_type,
+      .source_based_scoring_weight = meta.source_based_scoring_weight};
+    auto badgeroute_itr = _badgeroute.find(meta.badge_id);
+    if (badgeroute_itr == _badgeroute.end()) {
+      _badgeroute.emplace(get_self(), [&](auto& row){
+        row.badge_id = meta.badge_id;
+        row.routes.push_back(entry);
+      });
+      return;
+    }
+    for (auto& existing : badgeroute_itr->routes) {
+      if (existing.scoremeta_id == meta.scoremeta_id) {
+        return;
+      }
+    }
+    _badgeroute.modify(badgeroute_itr, get_self(), [&](auto& row) {
+      row.routes.push_back(entry);
     });
   }
-}*/
 
-  void balance_based_linear_score (name org, uint64_t scoremeta_id, name account, uint8_t count, uint64_t wt) {
-    scores_table _scores (get_self(), org.value);
-        
-  
-    auto score_account_index = _scores.get_index<name("scoreaccount")>();
-    uint128_t score_account_key = ((uint128_t) scoremeta_id) << 64 | account.value;
-    auto score_account_iterator = score_account_index.find (score_account_key);
-
-    if (score_account_iterator == score_account_index.end()) {
-      _scores.emplace(get_self(), [&](auto& row){
-        row.score_id = _scores.available_primary_key();
-        row.scoremeta_id = scoremeta_id;
-        row.account = account;
-        row.score = count * wt;
-        row.balance_count = count;
-      }); 
+  void remove_route (badgeroute_table& _badgeroute, const scoremeta& meta) {
+    auto badgeroute_itr = _badgeroute.find(meta.badge_id);
+    if (badgeroute_itr == _badgeroute.end()) {
+      return;
     }
-    else {
-      score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-        row.score = row.score + count * wt;
-        row.balance_count = row.balance_count + count;
+    auto routes = badgeroute_itr->routes;
+    routes.erase(std::remove_if(routes.begin(), routes.end(), [&](const route& entry) {
+      return entry.scoremeta_id == meta.scoremeta_id;
+    }), routes.end());
+    if (routes.empty()) {
+      _badgeroute.erase(badgeroute_itr);
+    } else if (routes.size() != badgeroute_itr->routes.size()) {
+      _badgeroute.modify(badgeroute_itr, get_self(), [&](auto& row) {
+        row.routes = routes;
       });
     }
   }
 
-  void balance_based_fibo_score (name org, uint64_t scoremeta_id, name account, uint8_t count, uint64_t wt) {
-    scores_table _scores (get_self(), org.value);
-      
-    auto score_account_index = _scores.get_index<name("scoreaccount")>();
-    uint128_t score_account_key = ((uint128_t) scoremeta_id) << 64 | account.value;
-    auto score_account_iterator = score_account_index.find (score_account_key);
-    
+  void mark_routed (name org) {
+    routedorg_table _routedorg (get_self(), get_self().value);
+    if (_routedorg.find(org.value) == _routedorg.end()) {
+      _routedorg.emplace(get_self(), [&](auto& row) {
+        row.org = org;
+      });
+    }
+  }
 
-    if (score_account_iterator == score_account_index.end()) {
-      uint64_t fib_num = fib (count); // optimize this.
-      _scores.emplace(get_self(), [&](auto& row){
-        row.score_id = _scores.available_primary_key();
-        row.scoremeta_id = scoremeta_id;
-        row.account = account;
-        row.score = fib_num * wt;
-        row.balance_count = count;
-      });  
+  // scores one issuance for a route or scoremeta row, both carry the scoring types and weights
+  template<typename Entry>
+  void score_route (name org, const Entry& entry, name account, name from, uint8_t count) {
+    const scoring::curve* balance_curve = scoring::find(entry.balance_based_scoring_type);
+    if (balance_curve != nullptr) {
+      balance_based_score (
+        org,
+        entry.scoremeta_id,
+        account,
+        count,
+        *balance_curve,
+        entry.balance_based_scoring_weight);
     }
-    else {
-      uint64_t fib_num = fib (count + score_account_iterator->balance_count); // optimize this.
-      score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-        row.score = row.score + fib_num * wt;
-        row.balance_count = row.balance_count + count;
-      });
+    const scoring::curve* source_curve = scoring::find(entry.source_based_scoring_type);
+    if (source_curve != nullptr) {
+      source_based_score (
+        org,
+        entry.scoremeta_id,
+        account,
+        from,
+        *source_curve,
+        entry.source_based_scoring_weight);
+    }
+    // insert total scores, badge scores
+  }
+
+  // scoremeta has no index by round, status changes scan the org's rows
+  void route_round (name org, name round, bool active) {
+    scoremeta_table _scoremeta (get_self(), org.value);
+    badgeroute_table _badgeroute (get_self(), org.value);
+    for (auto& meta : _scoremeta) {
+      if (meta.round != round) {
+        continue;
+      }
+      if (active) {
+        add_route(_badgeroute, meta);
+      } else {
+        remove_route(_badgeroute, meta);
+      }
+    }
+  }
+
+  // queues the snapshot of an ended round, finalize builds it
+  void start_finalization (name org, name round) {
+    finalization_table _finalization (get_self(), org.value);
+    if (_finalization.find(round.value) != _finalization.end()) {
+      return;
+    }
+    snapshotseq_table _snapshotseq (get_self(), get_self().value);
+    snapshotseq seq = _snapshotseq.get_or_default();
+    seq.last_snapshot_id++;
+    _snapshotseq.set(seq, get_self());
+
+    scoremeta_table _scoremeta (get_self(), org.value);
+    vector<uint64_t> scoremeta_ids;
+    for (auto& meta : _scoremeta) {
+      if (meta.round == round) {
+        scoremeta_ids.push_back(meta.scoremeta_id);
+      }
     }
+    _finalization.emplace(get_self(), [&](auto& row) {
+      row.round = round;
+      row.snapshot_id = seq.last_snapshot_id;
+      row.phase = name("totals");
+      row.scoremeta_ids = scoremeta_ids;
+      row.scoremeta_pos = 0;
+      row.account_cursor = 0;
+      row.accounts = 0;
+    });
   }
 
-  void source_based_linear_score (name org, uint64_t scoremeta_id, name account, name from, uint64_t wt) {
+  void balance_based_score (name org, uint64_t scoremeta_id, name account, uint8_t count, const scoring::curve& curve, uint64_t wt) {
     scores_table _scores (get_self(), org.value);
       
     auto score_account_index = _scores.get_index<name("scoreaccount")>();
     uint128_t score_account_key = ((uint128_t) scoremeta_id) << 64 | account.value;
     auto score_account_iterator = score_account_index.find (score_account_key);
 
-
-    uint8_t b = 7;
-    uint32_t m = 1 << b;
-    
     if (score_account_iterator == score_account_index.end()) {
-      
-      vector<uint8_t> M (m, 0);
-      hll::HyperLogLog hll(b, m, M );
-      hll.add(from.to_string().c_str(), from.to_string().size());
-      
       _scores.emplace(get_self(), [&](auto& row){
         row.score_id = _scores.available_primary_key();
         row.scoremeta_id = scoremeta_id;
         row.account = account;
-        row.score = wt;
-        row.source_count = 1;
-        row.hll = hll.registers();
+        row.score = scoring::mul(curve.points(count, count), wt);
+        row.balance_count = count;
+        row.source_count = 0;
       });  
-    } else if (score_account_iterator->hll.empty()) {
-      vector<uint8_t> M (m, 0);
-      hll::HyperLogLog hll(b, m, M );
-      hll.add(from.to_string().c_str(), from.to_string().size());
+    }
+    else {
+      uint64_t total = scoring::add(score_account_iterator->balance_count, count);
+      uint64_t points = scoring::mul(curve.points(total, count), wt);
       score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-        row.score = row.score + wt;
-        row.source_count = row.source_count + 1;
-        row.hll = hll.registers();
+        row.score = scoring::add(row.score, points);
+        row.balance_count = total;
       });
-
-    } else {
-      bool increment = false;
-
-      vector<uint8_t> M = score_account_iterator->hll;
-      hll::HyperLogLog hll(b, m, M);
-      double estimate_before = hll.estimate();
-      hll.add(from.to_string().c_str(), from.to_string().size());
-      double estimate_after = hll.estimate();
-
-      if(estimate_before != estimate_after) {
-        increment = true;
-      }
-      if(increment) {
-        score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-          row.score = row.score + wt;
-          row.source_count = row.source_count + 1;
-          row.hll = hll.registers();
-        });
-      }
     }
-
   }
 
-  void source_based_fibo_score (name org, uint64_t scoremeta_id, name account, name from, uint64_t wt) {
+  // rows created by balance based scoring have no hll yet, their first source counts as new
+  void source_based_score (name org, uint64_t scoremeta_id, name account, name from, const scoring::curve& curve, uint64_t wt) {
     scores_table _scores (get_self(), org.value);
       
     auto score_account_index = _scores.get_index<name("scoreaccount")>();
@@ -255,53 +343,26 @@ CONTRACT rounds : public contract {
     auto score_account_iterator = score_account_index.find (score_account_key);
 
 
-    uint8_t b = 7;
-    uint32_t m = 1 << b;
+    source_hll::element source(from.value);
     
     if (score_account_iterator == score_account_index.end()) {
-      vector<uint8_t> M (m, 0);
-      hll::HyperLogLog hll(b, m, M );
-      hll.add(from.to_string().c_str(), from.to_string().size());
-      
       _scores.emplace(get_self(), [&](auto& row){
         row.score_id = _scores.available_primary_key();
         row.scoremeta_id = scoremeta_id;
         row.account = account;
-        row.score = wt;
+        row.score = scoring::mul(curve.points(1, 1), wt);
+        row.balance_count = 0;
         row.source_count = 1;
-        row.hll = hll.registers();
+        source_hll(row.hll).add(source);
       });  
-    } else if (score_account_iterator->hll.empty()) {
-      vector<uint8_t> M (m, 0);
-      hll::HyperLogLog hll(b, m, M );
-      hll.add(from.to_string().c_str(), from.to_string().size());
+    } else if (score_account_iterator->hll.empty() || source_hll::raises(score_account_iterator->hll, source)) {
+      uint64_t total = score_account_iterator->source_count + 1;
+      uint64_t points = scoring::mul(curve.points(total, 1), wt);
       score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-        row.score = row.score + wt;
-        row.source_count = 1;
-        row.hll = hll.registers();
+        row.score = scoring::add(row.score, points);
+        row.source_count = total;
+        source_hll(row.hll).add(source);
       });
-
-    }
-    else {
-      bool increment = false;
-
-      vector<uint8_t> M = score_account_iterator->hll;
-      hll::HyperLogLog hll(b, m, M);
-      double estimate_before = hll.estimate();
-      hll.add(from.to_string().c_str(), from.to_string().size());
-      double estimate_after = hll.estimate();
-
-      if(estimate_before != estimate_after) {
-        increment = true;
-      }
-      if(increment) {
-        uint64_t fib_num = fib (1 + score_account_iterator->source_count); 
-        score_account_index.modify(score_account_iterator, get_self(), [&](auto& row) {
-          row.score = row.score + fib_num * wt;
-          row.source_count = row.source_count + 1;
-          row.hll = hll.registers();
-        });
-      }
     }
   }
 
@@ -0,0 +1,85 @@
+#if !defined(SCORING_HPP)
+#define SCORING_HPP
+
+/**
+ * @file scoring.hpp
+ * @brief Scoring curves selectable per scoremeta
+ *
+ * A curve turns an account's running total (badges held, or distinct
+ * sources) into the points one issuance adds, before the scoremeta weight.
+ * Fibonacci values come from a table built at compile time, every other
+ * curve is closed form. All arithmetic saturates at 2^64 - 1 instead of
+ * wrapping.
+ */
+
+#include <eosio/eosio.hpp>
+#include <array>
+#include <limits>
+
+namespace scoring {
+
+static constexpr uint64_t saturated = std::numeric_limits<uint64_t>::max();
+
+inline uint64_t add(uint64_t a, uint64_t b) {
+    return a > saturated - b ? saturated : a + b;
+}
+
+inline uint64_t mul(uint64_t a, uint64_t b) {
+    return (b != 0 && a > saturated / b) ? saturated : a * b;
+}
+
+// fib(93) is the largest fibonacci number that fits in 64 bits
+static constexpr size_t fibonacci_count = 94;
+
+constexpr std::array<uint64_t, fibonacci_count> make_fibonacci() {
+    std::array<uint64_t, fibonacci_count> table{};
+    table[1] = 1;
+    for (size_t i = 2; i < fibonacci_count; i++) {
+        table[i] = table[i - 1] + table[i - 2];
+    }
+    return table;
+}
+
+static constexpr std::array<uint64_t, fibonacci_count> fibonacci_table = make_fibonacci();
+
+inline uint64_t fibonacci(uint64_t n) {
+    return n < fibonacci_count ? fibonacci_table[n] : saturated;
+}
+
+// n-th triangular number, n (n + 1) / 2
+inline uint64_t quadratic(uint64_t n) {
+    return n % 2 == 0 ? mul(n / 2, add(n, 1)) : mul(n, (n + 1) / 2);
+}
+
+// bit length of n, 1 + floor(log2 n) for n > 0
+inline uint64_t logarithmic(uint64_t n) {
+    return n == 0 ? 0 : 64 - ::__builtin_clzll(n);
+}
+
+typedef uint64_t (*curve_fn)(uint64_t total, uint64_t added);
+
+struct curve {
+    eosio::name type;
+    curve_fn points;
+};
+
+// linear adds one point per unit, the others score the running total after the issuance
+static const curve curves[] = {
+    {eosio::name("linear"), [](uint64_t total, uint64_t added) { return added; }},
+    {eosio::name("fibonacci"), [](uint64_t total, uint64_t added) { return fibonacci(total); }},
+    {eosio::name("quadratic"), [](uint64_t total, uint64_t added) { return quadratic(total); }},
+    {eosio::name("log"), [](uint64_t total, uint64_t added) { return logarithmic(total); }},
+};
+
+inline const curve* find(eosio::name type) {
+    for (auto& entry : curves) {
+        if (entry.type == type) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace scoring
+
+#endif // !defined(SCORING_HPP)
@@ -11,72 +11,38 @@ void rounds::notifyachiev (
     uint64_t badge_id,  
     vector<name> notify_accounts) {
 
-    scoremeta_table _scoremeta (get_self(), org.value);
-    
-    auto badge_round_status_index = _scoremeta.get_index<name("badgestatus")>();
-    uint128_t badge_round_status_key = ((uint128_t) badge_id) << 64 | name("notended").value;
-    auto badge_round_status_iterator = badge_round_status_index.find (badge_round_status_key);
-
-    while (
-      (badge_round_status_iterator != badge_round_status_index.end()) &&
-      (badge_round_status_iterator->badge_id == badge_id) &&
-      (badge_round_status_iterator->round_status_tentative == name("notended"))) {
-
+    // orgs whose routes may miss rounds started before routes were kept score from the
+    // scoremeta scan until syncroutes has routed every active round
+    routedorg_table _routedorg (get_self(), get_self().value);
+    if (_routedorg.find(org.value) == _routedorg.end()) {
+      scoremeta_table _scoremeta (get_self(), org.value);
       rounds_table _rounds (get_self(), org.value);
-      auto rounds_itr = _rounds.find(badge_round_status_iterator->round.value);
+      auto badge_round_status_index = _scoremeta.get_index<name("badgestatus")>();
+      uint128_t badge_round_status_key = ((uint128_t) badge_id) << 64 | name("notended").value;
+      auto badge_round_status_iterator = badge_round_status_index.find (badge_round_status_key);
 
-      if (rounds_itr != _rounds.end()) {
-        if (rounds_itr->round_status == name("ended")) {
-          badge_round_status_index.modify(badge_round_status_iterator, get_self(), [&](auto& row) {
-            row.round_status_tentative = name("ended");
-          });
-        } 
-        if (rounds_itr->round_status == name("active")) {
-            switch(badge_round_status_iterator->balance_based_scoring_type) {
-            case name("linear"): 
-              balance_based_linear_score (
-                org,
-                badge_round_status_iterator->scoremeta_id,
-                account,
-                count,
-                badge_round_status_iterator->balance_based_scoring_weight);
-              break;
-            case name("fibonacci"):
-              balance_based_fibo_score (
-                org,
-                badge_round_status_iterator->scoremeta_id,
-                account,
-                count,
-                badge_round_status_iterator->balance_based_scoring_weight);
-              break;
-            default: ;
-          }
-          switch(badge_round_status_iterator->source_based_scoring_type) {
-            case name("linear"):
-              source_based_linear_score (
-                org,
-                badge_round_status_iterator->scoremeta_id,
-                account,
-                from,
-                badge_round_status_iterator->source_based_scoring_weight);
-              break;
-            case name("fibonacci"):
-              source_based_fibo_score (
-                org,
-                badge_round_status_iterator->scoremeta_id,
-                account,
-                from,
-                badge_round_status_iterator->source_based_scoring_weight);
-              break;
-            default: ;
-          }
-          // insert total scores, badge scores
+      while (
+        (badge_round_status_iterator != badge_round_status_index.end()) &&
+        (badge_round_status_iterator->badge_id == badge_id) &&
+        (badge_round_status_iterator->round_status_tentative == name("notended"))) {
+        auto rounds_itr = _rounds.find(badge_round_status_iterator->round.value);
+        if (rounds_itr != _rounds.end() && rounds_itr->round_status == name("active")) {
+          score_route(org, *badge_round_status_iterator, account, from, count);
         }
+        ++badge_round_status_iterator;
       }
-      ++badge_round_status_iterator;
-    } 
+      return;
+    }
 
+    badgeroute_table _badgeroute (get_self(), org.value);
+    auto badgeroute_itr = _badgeroute.find(badge_id);
+    if (badgeroute_itr == _badgeroute.end()) {
+      return;
+    }
 
+    for (auto& entry : badgeroute_itr->routes) {
+      score_route(org, entry, account, from, count);
+    }
   }
 
 ACTION rounds::createround (name org,
@@ -90,6 +56,11 @@ ACTION rounds::createround (name org,
   auto rounds_itr = _rounds.find(round.value);
   check(rounds_itr == _rounds.end(), "<round> already exists");
 
+  // an org without rounds has nothing started before routes were kept
+  if (_rounds.begin() == _rounds.end()) {
+    mark_routed(org);
+  }
+
   _rounds.emplace(get_self(), [&](auto& row){
     row.round = round;
     row.description = description;
@@ -110,6 +81,7 @@ ACTION rounds::startround (name org, name round) {
   _rounds.modify(rounds_itr, get_self(), [&](auto& row) {
     row.round_status = name("active");
   });
+  route_round(org, round, true);
 }
 
 ACTION rounds::endround (name org, name round) {
@@ -120,6 +92,17 @@ ACTION rounds::endround (name org, name round) {
   _rounds.modify(rounds_itr, get_self(), [&](auto& row) {
     row.round_status = name("ended");
   });
+  route_round(org, round, false);
+
+  scoremeta_table _scoremeta (get_self(), org.value);
+  for (auto scoremeta_itr = _scoremeta.begin(); scoremeta_itr != _scoremeta.end(); scoremeta_itr++) {
+    if (scoremeta_itr->round == round && scoremeta_itr->round_status_tentative != name("ended")) {
+      _scoremeta.modify(scoremeta_itr, get_self(), [&](auto& row) {
+        row.round_status_tentative = name("ended");
+      });
+    }
+  }
+  start_finalization(org, round);
 }
 
 ACTION rounds::pauseround (name org, name round) {
@@ -132,6 +115,7 @@ ACTION rounds::pauseround (name org, name round) {
   _rounds.modify(rounds_itr, get_self(), [&](auto& row) {
     row.round_status = name("paused");
   });
+  route_round(org, round, false);
 }
 
 ACTION rounds::resumeround (name org, name round) {
@@ -139,12 +123,102 @@ ACTION rounds::resumeround (name org, name round) {
   rounds_table _rounds( _self, org.value );
   auto rounds_itr = _rounds.find(round.value);
   check(rounds_itr != _rounds.end(), "<round> does not exist, create round using <createround> action");
-  check(rounds_itr->round_status == name("pause"), "can only resume from pause status");
+  check(rounds_itr->round_status == name("paused"), "can only resume from pause status");
   
   _rounds.modify(rounds_itr, get_self(), [&](auto& row) {
-    row.round_status = name("resume");
+    row.round_status = name("active");
   });
+  route_round(org, round, true);
+}
 
+ACTION rounds::syncroutes (name org) {
+  require_auth(org);
+  rounds_table _rounds( _self, org.value );
+  scoremeta_table _scoremeta (get_self(), org.value);
+  badgeroute_table _badgeroute (get_self(), org.value);
+  for (auto& meta : _scoremeta) {
+    auto rounds_itr = _rounds.find(meta.round.value);
+    if (rounds_itr != _rounds.end() && rounds_itr->round_status == name("active")) {
+      add_route(_badgeroute, meta);
+    }
+  }
+  mark_routed(org);
+}
+
+ACTION rounds::finalize (name org, name round, uint16_t max_rows) {
+  require_auth(org);
+  check(max_rows > 0, "<max_rows> must be greater than 0");
+  finalization_table _finalization (get_self(), org.value);
+  auto finalization_itr = _finalization.find(round.value);
+  check(finalization_itr != _finalization.end(), "<round> has no snapshot, end round using <endround> action");
+  check(finalization_itr->phase != name("done"), "snapshot of <round> is already final");
+
+  finalization state = *finalization_itr;
+  roundtotal_table _roundtotal (get_self(), state.snapshot_id);
+  uint32_t budget = max_rows;
+
+  if (state.phase == name("totals")) {
+    scores_table _scores (get_self(), org.value);
+    auto score_account_index = _scores.get_index<name("scoreaccount")>();
+    while (budget > 0 && state.scoremeta_pos < state.scoremeta_ids.size()) {
+      uint64_t scoremeta_id = state.scoremeta_ids[state.scoremeta_pos];
+      auto scores_itr = score_account_index.upper_bound(((uint128_t) scoremeta_id) << 64 | state.account_cursor);
+      for (; budget > 0 && scores_itr != score_account_index.end() && scores_itr->scoremeta_id == scoremeta_id; scores_itr++, budget--) {
+        auto roundtotal_itr = _roundtotal.find(scores_itr->account.value);
+        if (roundtotal_itr == _roundtotal.end()) {
+          _roundtotal.emplace(get_self(), [&](auto& row) {
+            row.account = scores_itr->account;
+            row.score = scores_itr->score;
+          });
+        } else {
+          _roundtotal.modify(roundtotal_itr, get_self(), [&](auto& row) {
+            row.score = scoring::add(row.score, scores_itr->score);
+          });
+        }
+        state.account_cursor = scores_itr->account.value;
+      }
+      if (budget > 0) {
+        state.scoremeta_pos++;
+        state.account_cursor = 0;
+      }
+    }
+    if (state.scoremeta_pos >= state.scoremeta_ids.size()) {
+      state.phase = name("ranking");
+    }
+  }
+
+  if (state.phase == name("ranking")) {
+    snapshot_table _snapshot (get_self(), state.snapshot_id);
+    uint64_t last_score = 0;
+    uint64_t last_rank = 0;
+    if (state.accounts > 0) {
+      auto& last = _snapshot.get(state.accounts, "snapshot is missing its last row");
+      last_score = last.score;
+      last_rank = last.rank;
+    }
+    auto rank_order_index = _roundtotal.get_index<name("rankorder")>();
+    auto roundtotal_itr = rank_order_index.begin();
+    for (; budget > 0 && roundtotal_itr != rank_order_index.end(); budget--) {
+      uint64_t position = ++state.accounts;
+      uint64_t rank = (position > 1 && roundtotal_itr->score == last_score) ? last_rank : position;
+      _snapshot.emplace(get_self(), [&](auto& row) {
+        row.position = position;
+        row.account = roundtotal_itr->account;
+        row.score = roundtotal_itr->score;
+        row.rank = rank;
+      });
+      last_score = roundtotal_itr->score;
+      last_rank = rank;
+      roundtotal_itr = rank_order_index.erase(roundtotal_itr);
+    }
+    if (roundtotal_itr == rank_order_index.end()) {
+      state.phase = name("done");
+    }
+  }
+
+  _finalization.modify(finalization_itr, get_self(), [&](auto& row) {
+    row = state;
+  });
 }
 
 ACTION rounds::addscoremeta (name org,
@@ -160,11 +234,14 @@ ACTION rounds::addscoremeta (name org,
   auto rounds_itr = _rounds.find(round.value);
   check(rounds_itr != _rounds.end(), "<round> does not exist, create round using <createround> action");
   check(rounds_itr->round_status != name("ended"), "<round> already ended");
+  check(balance_based_scoring_type == name() || scoring::find(balance_based_scoring_type) != nullptr, "unknown <balance_based_scoring_type>");
+  check(source_based_scoring_type == name() || scoring::find(source_based_scoring_type) != nullptr, "unknown <source_based_scoring_type>");
   
   scoremeta_table _scoremeta (_self, org.value);
+  uint64_t scoremeta_id = _scoremeta.available_primary_key();
 
   _scoremeta.emplace(get_self(), [&](auto& row){
-    row.scoremeta_id = _scoremeta.available_primary_key();
+    row.scoremeta_id = scoremeta_id;
     row.round = round;
     row.badge_id = badge_id;
     row.round_status_tentative = name("notended");
@@ -173,6 +250,11 @@ ACTION rounds::addscoremeta (name org,
     row.source_based_scoring_type = source_based_scoring_type;
     row.source_based_scoring_weight = source_based_scoring_weight;
   });  
+
+  if (rounds_itr->round_status == name("active")) {
+    badgeroute_table _badgeroute (_self, org.value);
+    add_route(_badgeroute, _scoremeta.get(scoremeta_id));
+  }
 }
 
 
@@ -1,5 +1,11 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/crypto.hpp>
+#include <hyperloglog.hpp>
+#include <leaderboard.hpp>
+#include <topholders.hpp>
+#include <quantiles.hpp>
+#include <eventlog.hpp>
 
 #define CUMULATIVE_CONTRACT "cumulativeyy"
 #define ORCHESTRATOR_CONTRACT "orchyyyyyyyy"
@@ -8,6 +14,9 @@
 #define SUBSCRIPTION_CONTRACT "subsyyyyyyyy"
 
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
+#define NEW_BADGE_BATCH_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifybatch"
+#define NEW_BADGE_COMPACT_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachv2"
+
 
 
 using namespace std;
@@ -17,8 +26,59 @@ CONTRACT statistics : public contract {
   public:
     using contract::contract;
 
+    struct achievement_event {
+      asset badge_asset;
+      name from;
+      name to;
+      string memo;
+    };
+
+    struct balancequantiles {
+      uint64_t holders;
+      uint64_t p50;
+      uint64_t p90;
+      uint64_t p99;
+      bool complete;    // false when holders predate the sketch, their balances are missing or misplaced
+    };
+
+    struct balancehistogram {
+      vector<uint32_t> log2_counts;
+      bool complete;    // as in balancequantiles
+    };
+
     ACTION dummy();
 
+    ACTION crank(name org, uint16_t max_events);
+
+    // keeps only the top_k highest balances of badge_symbol from now on, seeded from the leaderboard.
+    // the leaderboard is no longer updated for the badge, so the mode cannot be changed once set.
+    ACTION settopk(symbol badge_symbol, uint16_t top_k);
+
+    // moves up to max_accounts accounts of badge_symbol from the legacy ranks rows into the leaderboard
+    ACTION migrateranks(symbol badge_symbol, uint16_t max_accounts);
+
+    // erases up to max_rows leaderboard nodes of a badge in top-K mode, nothing reads them any more
+    ACTION freeranks(symbol badge_symbol, uint16_t max_rows);
+
+    // competition rank of account in badge_symbol, 0 if it holds none or is outside the top-K
+    [[eosio::action, eosio::read_only]]
+    uint64_t rankof(symbol badge_symbol, name account);
+
+    // count accounts of badge_symbol from position first_rank, highest balance first.
+    // accounts still in legacy ranks rows are left out until migrateranks has moved them.
+    [[eosio::action, eosio::read_only]]
+    vector<rankentry> rankrange(symbol badge_symbol, uint64_t first_rank, uint32_t count);
+
+    // balance quantiles of the holders of badge_symbol, within 1/16 of the true balance above 8.
+    // only complete for badges whose first holder was recorded by the sketch.
+    [[eosio::action, eosio::read_only]]
+    balancequantiles balancequant(name org, symbol badge_symbol);
+
+    // holders of badge_symbol per power of two of the balance, bucket i is [2^i, 2^(i+1)).
+    // only complete for badges whose first holder was recorded by the histogram.
+    [[eosio::action, eosio::read_only]]
+    balancehistogram balancehist(name org, symbol badge_symbol);
+
     [[eosio::on_notify(NEW_BADGE_ISSUANCE_NOTIFICATION)]] void notifyachiev(
     name org,
     asset badge_asset, 
@@ -27,7 +87,28 @@ CONTRACT statistics : public contract {
     string memo, 
     vector<name> notify_accounts);
 
+    [[eosio::on_notify(NEW_BADGE_BATCH_NOTIFICATION)]] void notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events);
+
+    [[eosio::on_notify(NEW_BADGE_COMPACT_NOTIFICATION)]] void notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash);
+
   private:
+    // 2^10 registers per badge wide hll, about 3% standard error
+    typedef hll::PackedHyperLogLog<10> badge_hll;
+
+    // 8 buckets per power of two of the balance
+    typedef quantile::LogLinearSketch<3> balance_sketch;
+
     // scoped by org
     TABLE counts {
         symbol badge_symbol;
@@ -37,7 +118,35 @@ CONTRACT statistics : public contract {
     };
     typedef multi_index<"counts"_n, counts> counts_table;
 
-    // scoped by badge_symbol
+    // scoped by org, estimated distinct givers and recipients of a badge
+    TABLE cardinality {
+        symbol badge_symbol;
+        vector<uint8_t> giver_hll;
+        vector<uint8_t> recipient_hll;   // cross-check on counts::total_recipients
+        uint64_t primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<"cardinality"_n, cardinality> cardinality_table;
+
+    // scoped by org, holders of a badge bucketed by balance, see balance_sketch
+    TABLE distribution {
+        symbol badge_symbol;
+        vector<uint32_t> balance_counts;
+        bool complete;      // the row was created by the first holder of the badge
+        uint64_t primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<"distribution"_n, distribution> distribution_table;
+
+    // scoped by org, holders of a badge per power of two of the balance, see quantile::Log2Histogram
+    TABLE histogram {
+        symbol badge_symbol;
+        vector<uint32_t> log2_counts;
+        bool complete;      // the row was created by the first holder of the badge
+        uint64_t primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<"histogram"_n, histogram> histogram_table;
+
+    // scoped by badge_symbol, superseded by the leaderboard of the same scope.
+    // rows left here are moved over by migrateranks or when their accounts next change.
     TABLE ranks {
         vector<name> accounts;
         uint64_t balance;
@@ -45,6 +154,17 @@ CONTRACT statistics : public contract {
     };
     typedef multi_index<"ranks"_n, ranks> ranks_table;
 
+    // scoped by badge_symbol, balance an account was last applied at. the crank adds a row
+    // for each account it applies, since a balance read back from cumulative minus the
+    // drained amounts is not the applied one once the event log has dropped events.
+    // pushed issuances keep existing rows current.
+    TABLE applied {
+        name account;
+        uint64_t balance;
+        uint64_t primary_key() const { return account.value; }
+    };
+    typedef multi_index<"applied"_n, applied> applied_table;
+
     // scoped by recepient
     TABLE account {
         asset    balance;
@@ -52,17 +172,6 @@ CONTRACT statistics : public contract {
     };
     typedef eosio::multi_index<"accounts"_n, account> accounts;
 
-    // scoped by org
-    TABLE badge {
-        symbol badge_symbol;
-        vector<name> notify_accounts;
-        string offchain_lookup_data;
-        string onchain_lookup_data;
-        uint64_t rarity_counts;
-        auto primary_key() const { return badge_symbol.code().raw(); }
-    };
-    typedef multi_index<name("badge"), badge> badge_table;
-
     // scoped by contract
     TABLE auth {
       name action;
@@ -84,44 +193,58 @@ CONTRACT statistics : public contract {
       check(false, failure_identifier + "Calling contract not in authorized list of accounts for action " + action.to_string());
     }
 
-    void update_rank(name org, name account, symbol badge_symbol, uint64_t old_balance, uint64_t new_balance) {
+    // board and _ranks are scoped by badge_symbol, top replaces both once settopk has run
+    void update_rank(topholders& top, leaderboard& board, ranks_table& _ranks, name account, uint64_t old_balance, uint64_t new_balance) {
+        if (top.capacity() > 0) {
+            top.update(account, new_balance, get_self());
+            return;
+        }
+        if (old_balance != new_balance && !board.remove(account, old_balance, get_self())) {
+            remove_legacy_rank(_ranks, account, old_balance);
+        }
+        board.insert(account, new_balance, get_self());
+    }
 
-        ranks_table _ranks(get_self(), badge_symbol.code().raw()); // Use badge_agg_seq_id as scope
-        // Check and remove the player's name from the old score, if provided and different
+    void remove_legacy_rank(ranks_table& _ranks, name account, uint64_t balance) {
+        auto old_itr = _ranks.find(balance);
+        if (old_itr != _ranks.end()) {
+            auto old_names = old_itr->accounts;
+            old_names.erase(std::remove(old_names.begin(), old_names.end(), account), old_names.end());
+            if (old_names.empty()) {
+                _ranks.erase(old_itr); // Remove the score entry if no names are left
+            } else {
+                _ranks.modify(old_itr, get_self(), [&](auto& entry) {
+                    entry.accounts = old_names;
+                });
+            }
+        }
+    }
 
-        if (old_balance != new_balance) {
-            auto old_itr = _ranks.find(old_balance);
-            if (old_itr != _ranks.end()) {
-                auto old_names = old_itr->accounts;
-                old_names.erase(std::remove(old_names.begin(), old_names.end(), account), old_names.end());
-                if (old_names.empty()) {
-                    _ranks.erase(old_itr); // Remove the score entry if no names are left
-                } else {
-                    _ranks.modify(old_itr, get_self(), [&](auto& entry) {
-                        entry.accounts = old_names;
-                    });
-                }
+    // _counts is scoped by org
+    // balance account was applied at before new_balance, fallback if it has no applied row.
+    // records new_balance, untracked accounts get a row only when track is set.
+    uint64_t swap_applied(applied_table& _applied, name account, uint64_t fallback, uint64_t new_balance, bool track) {
+        auto applied_itr = _applied.find(account.value);
+        if (applied_itr == _applied.end()) {
+            if (track) {
+                _applied.emplace(get_self(), [&](auto& row) {
+                    row.account = account;
+                    row.balance = new_balance;
+                });
             }
+            return fallback;
         }
-        auto new_itr = _ranks.find(new_balance);
-        if (new_itr == _ranks.end()) {
-            _ranks.emplace(get_self(), [&](auto& entry) {
-                entry.balance = new_balance;
-                entry.accounts.push_back(account);
+        uint64_t old_balance = applied_itr->balance;
+        if (old_balance != new_balance) {
+            _applied.modify(applied_itr, get_self(), [&](auto& row) {
+                row.balance = new_balance;
             });
-        } else {
-            if (std::find(new_itr->accounts.begin(), new_itr->accounts.end(), account) == new_itr->accounts.end()) {
-                _ranks.modify(new_itr, get_self(), [&](auto& entry) {
-                    entry.accounts.push_back(account);
-                });
-            } // If player name already exists for this score, no action needed
         }
-            
-
+        return old_balance;
     }
 
-    void update_count(name org, name account, symbol badge_symbol, uint64_t old_balance, uint64_t new_balance) {
-        counts_table _counts(get_self(), org.value);
+    // returns total_recipients after the update
+    uint64_t update_count(counts_table& _counts, symbol badge_symbol, uint64_t old_balance, uint64_t new_balance) {
         auto counts_itr = _counts.find(badge_symbol.code().raw());
         uint64_t total_recipients;
         uint64_t total_issued;
@@ -144,6 +267,100 @@ CONTRACT statistics : public contract {
                 entry.total_issued = total_issued;
             });
         }
+        return total_recipients;
+    }
+
+    // _cardinality is scoped by org, the row is only written when from or to is new to the badge.
+    // rows are kept packed, a badge row outgrows sparse within a few hundred senders and
+    // a packed add sets its register in place without reallocating.
+    void update_cardinality(cardinality_table& _cardinality, symbol badge_symbol, name from, name to) {
+        badge_hll::element giver(from.value);
+        badge_hll::element recipient(to.value);
+        auto cardinality_itr = _cardinality.find(badge_symbol.code().raw());
+        if (cardinality_itr == _cardinality.end()) {
+            _cardinality.emplace(get_self(), [&](auto& row) {
+                row.badge_symbol = badge_symbol;
+                badge_hll giver_hll(row.giver_hll);
+                giver_hll.pack();
+                giver_hll.add(giver);
+                badge_hll recipient_hll(row.recipient_hll);
+                recipient_hll.pack();
+                recipient_hll.add(recipient);
+            });
+        } else if (badge_hll::raises(cardinality_itr->giver_hll, giver) | badge_hll::raises(cardinality_itr->recipient_hll, recipient)) {
+            _cardinality.modify(cardinality_itr, get_self(), [&](auto& row) {
+                badge_hll giver_hll(row.giver_hll);
+                giver_hll.pack();
+                giver_hll.add(giver);
+                badge_hll recipient_hll(row.recipient_hll);
+                recipient_hll.pack();
+                recipient_hll.add(recipient);
+            });
+        }
+    }
+
+    // _distribution is scoped by org, balances issued before the row existed are not in it.
+    // first_holder: this update made the first recipient of the badge, so none is missing.
+    void update_distribution(distribution_table& _distribution, symbol badge_symbol, uint64_t old_balance, uint64_t new_balance, bool first_holder) {
+        auto distribution_itr = _distribution.find(badge_symbol.code().raw());
+        if (distribution_itr == _distribution.end()) {
+            _distribution.emplace(get_self(), [&](auto& row) {
+                row.badge_symbol = badge_symbol;
+                row.complete = first_holder;
+                balance_sketch(row.balance_counts).move(0, new_balance);
+            });
+        } else {
+            _distribution.modify(distribution_itr, get_self(), [&](auto& row) {
+                balance_sketch(row.balance_counts).move(old_balance, new_balance);
+            });
+        }
+    }
+
+    // _histogram is scoped by org, the row is only written when the balance changes bucket.
+    // first_holder as in update_distribution.
+    void update_histogram(histogram_table& _histogram, symbol badge_symbol, uint64_t old_balance, uint64_t new_balance, bool first_holder) {
+        auto histogram_itr = _histogram.find(badge_symbol.code().raw());
+        if (histogram_itr == _histogram.end()) {
+            _histogram.emplace(get_self(), [&](auto& row) {
+                row.badge_symbol = badge_symbol;
+                row.complete = first_holder;
+                quantile::Log2Histogram(row.log2_counts).move(0, new_balance);
+            });
+        } else if (quantile::Log2Histogram::moves(old_balance, new_balance)) {
+            _histogram.modify(histogram_itr, get_self(), [&](auto& row) {
+                quantile::Log2Histogram(row.log2_counts).move(old_balance, new_balance);
+            });
+        }
+    }
+
+    // badge_totals: badge -> recipient -> amount issued.
+    // pending: amounts already in cumulative balances that were issued after badge_totals.
+    // track: take old balances from applied rows, see applied.
+    void apply_badge_totals(name org, const std::map<symbol, std::map<name, uint64_t>>& badge_totals, const std::map<std::pair<symbol, name>, uint64_t>& pending, bool track) {
+        counts_table _counts(get_self(), org.value);
+        distribution_table _distribution(get_self(), org.value);
+        histogram_table _histogram(get_self(), org.value);
+        for (auto& [badge_symbol, recipient_totals] : badge_totals) {
+            topholders top(get_self(), badge_symbol.code().raw());
+            leaderboard board(get_self(), badge_symbol.code().raw());
+            ranks_table _ranks(get_self(), badge_symbol.code().raw());
+            applied_table _applied(get_self(), badge_symbol.code().raw());
+            for (auto& [to, amount] : recipient_totals) {
+                accounts _accounts(name(CUMULATIVE_CONTRACT), to.value);
+                auto accounts_itr = _accounts.find(badge_symbol.code().raw());
+
+                uint64_t new_balance = (accounts_itr == _accounts.end()) ? 0 : accounts_itr->balance.amount;
+                auto pending_itr = pending.find({badge_symbol, to});
+                if (pending_itr != pending.end()) {
+                    new_balance -= pending_itr->second;
+                }
+                uint64_t old_balance = swap_applied(_applied, to, new_balance - amount, new_balance, track);
+                update_rank(top, board, _ranks, to, old_balance, new_balance);
+                bool first_holder = update_count(_counts, badge_symbol, old_balance, new_balance) == 1 && old_balance == 0;
+                update_distribution(_distribution, badge_symbol, old_balance, new_balance, first_holder);
+                update_histogram(_histogram, badge_symbol, old_balance, new_balance, first_holder);
+            }
+        }
     }
 
     struct billing_args {
@@ -151,4 +368,9 @@ CONTRACT statistics : public contract {
       uint8_t actions_used;
     };
 
+    struct billbulk_args {
+      name org;
+      uint64_t actions_used;
+    };
+
 };
@@ -15,8 +15,20 @@ void statistics::notifyachiev(
     auto accounts_itr = _accounts.find(badge_asset.symbol.code().raw());
     
     uint64_t new_balance = (accounts_itr == _accounts.end()) ? 0 : accounts_itr->balance.amount;
-    update_rank(org, to, badge_asset.symbol, new_balance - badge_asset.amount, new_balance);
-    update_count(org, to, badge_asset.symbol, new_balance - badge_asset.amount, new_balance);
+    topholders top(get_self(), badge_asset.symbol.code().raw());
+    leaderboard board(get_self(), badge_asset.symbol.code().raw());
+    ranks_table _ranks(get_self(), badge_asset.symbol.code().raw());
+    counts_table _counts(get_self(), org.value);
+    cardinality_table _cardinality(get_self(), org.value);
+    distribution_table _distribution(get_self(), org.value);
+    histogram_table _histogram(get_self(), org.value);
+    applied_table _applied(get_self(), badge_asset.symbol.code().raw());
+    uint64_t old_balance = swap_applied(_applied, to, new_balance - badge_asset.amount, new_balance, false);
+    update_rank(top, board, _ranks, to, old_balance, new_balance);
+    bool first_holder = update_count(_counts, badge_asset.symbol, old_balance, new_balance) == 1 && old_balance == 0;
+    update_distribution(_distribution, badge_asset.symbol, old_balance, new_balance, first_holder);
+    update_histogram(_histogram, badge_asset.symbol, old_balance, new_balance, first_holder);
+    update_cardinality(_cardinality, badge_asset.symbol, from, to);
     
     action {
         permission_level{get_self(), name("active")},
@@ -28,6 +40,212 @@ void statistics::notifyachiev(
     }.send();
 }
 
+void statistics::notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash) {
+    if (notify_account != get_self()) {
+        return;
+    }
+    // v2 events carry neither memo nor notify_accounts, neither is used here
+    notifyachiev(org, asset(amount, badge_symbol), from, to, "", {});
+}
+
+void statistics::notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events) {
+
+    if (notify_account != get_self()) {
+        return;
+    }
+
+    // cumulative has already applied the whole batch, so each (badge, recipient)
+    // pair is updated once from its summed amount.
+    std::map<symbol, std::map<name, uint64_t>> badge_totals;
+    cardinality_table _cardinality(get_self(), org.value);
+    for (auto& event : events) {
+        badge_totals[event.badge_asset.symbol][event.to] += event.badge_asset.amount;
+        update_cardinality(_cardinality, event.badge_asset.symbol, event.from, event.to);
+    }
+
+    apply_badge_totals(org, badge_totals, {}, false);
+
+    action {
+        permission_level{get_self(), name("active")},
+        name(SUBSCRIPTION_CONTRACT),
+        name("billbulk"),
+        billbulk_args {
+            .org = org,
+            .actions_used = events.size()}
+    }.send();
+}
+
+ACTION statistics::crank(name org, uint16_t max_events) {
+    uint64_t head_log_seq = 0;
+    eventlog_reader event_log(get_self(), name(ORCHESTRATOR_CONTRACT));
+    vector<eventlog> events = event_log.drain(org, max_events, head_log_seq);
+    if (events.empty()) {
+        return;
+    }
+
+    std::map<uint64_t, bool> followed_badges;
+    std::map<symbol, std::map<name, uint64_t>> badge_totals;
+    cardinality_table _cardinality(get_self(), org.value);
+    uint64_t actions_used = 0;
+    for (auto& event : events) {
+        if (!event_log.follows_badge(org, event.badge_symbol, followed_badges)) {
+            continue;
+        }
+        badge_totals[event.badge_symbol][event.to] += event.amount;
+        update_cardinality(_cardinality, event.badge_symbol, event.from, event.to);
+        actions_used++;
+    }
+    if (actions_used == 0) {
+        return;
+    }
+
+    // cumulative balances already include issuances logged after this chunk
+    std::map<std::pair<symbol, name>, uint64_t> pending;
+    for (auto& later : event_log.pending(org, events.back().log_seq, head_log_seq)) {
+        pending[{later.badge_symbol, later.to}] += later.amount;
+    }
+
+    apply_badge_totals(org, badge_totals, pending, true);
+
+    action {
+        permission_level{get_self(), name("active")},
+        name(SUBSCRIPTION_CONTRACT),
+        name("billbulk"),
+        billbulk_args {
+            .org = org,
+            .actions_used = actions_used}
+    }.send();
+}
+
+ACTION statistics::settopk(symbol badge_symbol, uint16_t top_k) {
+    string action_name = "settopk";
+    string failure_identifier = "CONTRACT: statistics, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+    check(top_k > 0 && top_k <= TOPHOLDERS_MAX_CAPACITY, failure_identifier + "top_k must be between 1 and " + std::to_string(TOPHOLDERS_MAX_CAPACITY));
+
+    topholders top(get_self(), badge_symbol.code().raw());
+    check(top.capacity() == 0, failure_identifier + "top-K mode already set for " + badge_symbol.code().to_string());
+
+    // legacy ranks rows must be migrated first or their accounts would be missed
+    ranks_table _ranks(get_self(), badge_symbol.code().raw());
+    check(_ranks.begin() == _ranks.end(), failure_identifier + "run migrateranks for " + badge_symbol.code().to_string() + " first");
+
+    top.set_capacity(top_k, get_self());
+    leaderboard board(get_self(), badge_symbol.code().raw());
+    for (auto& entry : board.range(1, top_k)) {
+        top.update(entry.account, entry.balance, get_self());
+    }
+}
+
+ACTION statistics::freeranks(symbol badge_symbol, uint16_t max_rows) {
+    string action_name = "freeranks";
+    string failure_identifier = "CONTRACT: statistics, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    topholders top(get_self(), badge_symbol.code().raw());
+    check(top.capacity() > 0, failure_identifier + badge_symbol.code().to_string() + " is not in top-K mode");
+    leaderboard board(get_self(), badge_symbol.code().raw());
+    board.clear(max_rows);
+}
+
+ACTION statistics::migrateranks(symbol badge_symbol, uint16_t max_accounts) {
+    string action_name = "migrateranks";
+    string failure_identifier = "CONTRACT: statistics, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    leaderboard board(get_self(), badge_symbol.code().raw());
+    ranks_table _ranks(get_self(), badge_symbol.code().raw());
+    uint16_t moved = 0;
+    auto ranks_itr = _ranks.begin();
+    while (ranks_itr != _ranks.end() && moved < max_accounts) {
+        auto names = ranks_itr->accounts;
+        while (!names.empty() && moved < max_accounts) {
+            board.insert(names.back(), ranks_itr->balance, get_self());
+            names.pop_back();
+            moved++;
+        }
+        if (names.empty()) {
+            ranks_itr = _ranks.erase(ranks_itr);
+        } else {
+            _ranks.modify(ranks_itr, get_self(), [&](auto& entry) {
+                entry.accounts = names;
+            });
+        }
+    }
+}
+
+uint64_t statistics::rankof(symbol badge_symbol, name account) {
+    accounts _accounts(name(CUMULATIVE_CONTRACT), account.value);
+    auto accounts_itr = _accounts.find(badge_symbol.code().raw());
+    if (accounts_itr == _accounts.end()) {
+        return 0;
+    }
+    uint64_t balance = accounts_itr->balance.amount;
+    topholders top(get_self(), badge_symbol.code().raw());
+    if (top.capacity() > 0) {
+        return top.rank_of(account);
+    }
+    leaderboard board(get_self(), badge_symbol.code().raw());
+    uint64_t rank = board.rank_of(balance);
+
+    // legacy rows not yet migrated still hold some of the higher balances
+    ranks_table _ranks(get_self(), badge_symbol.code().raw());
+    for (auto ranks_itr = _ranks.upper_bound(balance); ranks_itr != _ranks.end(); ranks_itr++) {
+        rank += ranks_itr->accounts.size();
+    }
+    return rank;
+}
+
+vector<rankentry> statistics::rankrange(symbol badge_symbol, uint64_t first_rank, uint32_t count) {
+    topholders top(get_self(), badge_symbol.code().raw());
+    if (top.capacity() > 0) {
+        return top.range(first_rank, count);
+    }
+    leaderboard board(get_self(), badge_symbol.code().raw());
+    return board.range(first_rank, count);
+}
+
+statistics::balancequantiles statistics::balancequant(name org, symbol badge_symbol) {
+    distribution_table _distribution(get_self(), org.value);
+    auto distribution_itr = _distribution.find(badge_symbol.code().raw());
+    if (distribution_itr == _distribution.end()) {
+        // holders recorded before the sketch existed have not been issued the badge since
+        counts_table _counts(get_self(), org.value);
+        return balancequantiles{0, 0, 0, 0, _counts.find(badge_symbol.code().raw()) == _counts.end()};
+    }
+    auto& counts = distribution_itr->balance_counts;
+    return balancequantiles{
+        .holders = balance_sketch::total(counts),
+        .p50 = balance_sketch::quantile(counts, 500),
+        .p90 = balance_sketch::quantile(counts, 900),
+        .p99 = balance_sketch::quantile(counts, 990),
+        .complete = distribution_itr->complete};
+}
+
+statistics::balancehistogram statistics::balancehist(name org, symbol badge_symbol) {
+    histogram_table _histogram(get_self(), org.value);
+    auto histogram_itr = _histogram.find(badge_symbol.code().raw());
+    if (histogram_itr == _histogram.end()) {
+        // holders recorded before the histogram existed have not been issued the badge since
+        counts_table _counts(get_self(), org.value);
+        return balancehistogram{
+            vector<uint32_t>(quantile::Log2Histogram::bucket_count, 0),
+            _counts.find(badge_symbol.code().raw()) == _counts.end()};
+    }
+    return balancehistogram{histogram_itr->log2_counts, histogram_itr->complete};
+}
+
 ACTION statistics::dummy() {
 }
 
@@ -1,6 +1,5 @@
 #include <eosio/eosio.hpp>
 
-#define CUMULATIVE_CONTRACT_NAME "router111111"
 #define NEW_BADGE_ISSUANCE_NOTIFICATION "nb"
 
 using namespace std;
@@ -12,10 +11,11 @@ CONTRACT stats : public contract {
 
     ACTION bootstrap(name org,
       name badge, 
-      uint64_t max, 
-      uint64_t mean,
-      uint64_t account_count, 
-      uint64_t total);
+      uint64_t issuances,
+      uint64_t total,
+      uint128_t sum_squares,
+      uint64_t max,
+      uint64_t min);
 
     [[eosio::on_notify(NEW_BADGE_ISSUANCE_NOTIFICATION)]] void notifyachiev (
       name org, 
@@ -28,6 +28,7 @@ CONTRACT stats : public contract {
       vector<name> notify_accounts);
 
   private:
+    // legacy per-badge balance stats, no longer written. kept so existing rows stay readable.
     TABLE keystats {
       name    badge;
       uint64_t  max;
@@ -38,17 +39,16 @@ CONTRACT stats : public contract {
     };
     typedef multi_index<name("keystats"), keystats> keystats_table;
 
-    TABLE achievements {
-      uint64_t id;
-      name account;
-      uint64_t badge_id;
-      uint64_t count;
-      auto primary_key() const {return id; }
-      uint128_t acc_badge_key() const {
-        return ((uint128_t) account.value) << 64 | badge_id;
-      }
+    // scoped by org, running aggregates of the amounts issued per event.
+    // mean is total / issuances, variance is sum_squares / issuances - mean^2.
+    TABLE keystats2 {
+      name    badge;
+      uint64_t issuances;
+      uint64_t total;
+      uint128_t sum_squares;
+      uint64_t max;
+      uint64_t min;
+      auto primary_key() const { return badge.value; }
     };
-    typedef multi_index<name("achievements"), achievements,
-    indexed_by<name("accountbadge"), const_mem_fun<achievements, uint128_t, &achievements::acc_badge_key>>
-    > achievements_table;
+    typedef multi_index<name("keystats2"), keystats2> keystats2_table;
 };
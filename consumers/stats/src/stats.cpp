@@ -11,83 +11,59 @@ void stats::notifyachiev (
       uint64_t badge_id,  
       vector<name> notify_accounts) {
 
-    keystats_table _keystats( _self, org.value );  
+    // every aggregate follows from the event's own count, no balance is read
+    keystats2_table _keystats( _self, org.value );  
     auto keystats_itr = _keystats.find(badge_name.value);
-
+    uint128_t square = (uint128_t) count * count;
 
     if(keystats_itr == _keystats.end()) {
       _keystats.emplace(get_self(), [&](auto& row){
         row.badge = badge_name;
+        row.issuances = 1;
+        row.total = count;
+        row.sum_squares = square;
         row.max = count;
-        row.mean = count;
-        row.account_count = 1;
-        row.total = row.total + count;
+        row.min = count;
       });
     } else {
-
-      achievements_table _achievements( name(CUMULATIVE_CONTRACT_NAME), org.value );
-      auto account_badge_index = _achievements.get_index<name("accountbadge")>();
-      uint128_t account_badge_key = ((uint128_t) account.value) << 64 | badge_id;
-      auto account_badge_iterator = account_badge_index.find (account_badge_key);
-
-      if(account_badge_iterator == account_badge_index.end() || account_badge_iterator->account != account || account_badge_iterator->badge_id!=badge_id) {
-        check(false, "possibly cumulative consumer is not followed by stats consumer");
-      } else {
-        uint64_t balance = account_badge_iterator->count;
-        uint64_t  max;
-        uint64_t mean;
-        uint64_t account_count;
-        uint64_t total; 
-        if(balance > keystats_itr->max) {
-          max = balance;
-        } else {
-          max = keystats_itr->max;
-        }
-        if(balance == count) {
-          account_count = keystats_itr->account_count + 1;
-        } else {
-          account_count = keystats_itr->account_count;
-        }
-        total = total + count;
-        mean = total / account_count;
-
-        _keystats.modify(keystats_itr, get_self(), [&](auto& row) {
-          row.max = max;
-          row.mean = mean;
-          row.account_count = account_count;
-          row.total = total;
-        });
-      }
-
+      _keystats.modify(keystats_itr, get_self(), [&](auto& row) {
+        row.issuances++;
+        row.total += count;
+        row.sum_squares += square;
+        row.max = std::max(row.max, count);
+        row.min = std::min(row.min, count);
+      });
     }
 }
 
 ACTION stats::bootstrap(name org,
       name badge, 
-      uint64_t max, 
-      uint64_t mean,
-      uint64_t account_count, 
-      uint64_t total) {
+      uint64_t issuances,
+      uint64_t total,
+      uint128_t sum_squares,
+      uint64_t max,
+      uint64_t min) {
     require_auth(get_self());
-    keystats_table _keystats( _self, org.value );  
+    keystats2_table _keystats( _self, org.value );  
     auto keystats_itr = _keystats.find(badge.value);
 
     if(keystats_itr == _keystats.end()) {
       _keystats.emplace(get_self(), [&](auto& row){
         row.badge = badge;
+        row.issuances = issuances;
+        row.total = total;
+        row.sum_squares = sum_squares;
         row.max = max;
-        row.mean = mean;
-        row.account_count = account_count;
-        row.total = row.total;
+        row.min = min;
       });
     } else {
       _keystats.modify(keystats_itr, get_self(), [&](auto& row) {
-        row.max = max;
-        row.mean = mean;
-        row.account_count = account_count;
+        row.issuances = issuances;
         row.total = total;
+        row.sum_squares = sum_squares;
+        row.max = max;
+        row.min = min;
       });
     }
 
 }
-
@@ -1,5 +1,6 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eosio/crypto.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -8,10 +9,19 @@ using namespace eosio;
 #define AUTHORITY_CONTRACT "authorityyyy"
 #define ORG_CONTRACT "organizayyyy"
 
+#define EVENT_LOG_SIZE 512
+
 CONTRACT metadata : public contract {
 public:
   using contract::contract;
 
+  struct achievement_event {
+    asset badge_asset;
+    name from;
+    name to;
+    string memo;
+  };
+
   ACTION initbadge(
     name org,
     symbol badge_symbol, 
@@ -64,6 +74,31 @@ public:
     string memo, 
     vector<name> notify_accounts);
 
+  ACTION notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash);
+
+  ACTION achievebatch(
+    name org,
+    vector<achievement_event> events);
+
+  ACTION notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events);
+
+  ACTION setnotifycap(
+    name notify_account,
+    bool batch,
+    bool compact,
+    bool pull);
+
   ACTION mergeinfo(
     name org,
     symbol badge_symbol, 
@@ -93,6 +128,23 @@ private:
     vector<name> notify_accounts;
   };
 
+  struct notifyachv2_args {
+    name org;
+    name notify_account;
+    symbol badge_symbol;
+    uint64_t amount;
+    name from;
+    name to;
+    uint64_t event_seq;
+    std::optional<checksum256> memo_hash;
+  };
+
+  struct notifybatch_args {
+    name org;
+    name notify_account;
+    vector<achievement_event> events;
+  };
+
   struct downstream_notify_args {
     name org;
     symbol badge_symbol;
@@ -125,6 +177,209 @@ private:
   };
   typedef multi_index<name("badge"), badge> badge_table;
 
+  // scoped by org
+  // hot issuance counters kept apart from the descriptive badge row so that
+  // achievement does not rewrite lookup data and notify_accounts on every issuance.
+  // rarity_counts in badge row is the frozen pre-split value and seeds this row.
+  TABLE badgecount {
+    symbol badge_symbol;
+    uint64_t rarity_counts;
+    auto primary_key() const { return badge_symbol.code().raw(); }
+  };
+  typedef multi_index<name("badgecounts"), badgecount> badgecount_table;
+
+  uint64_t get_rarity_counts(name org, const badge& badge_row) {
+    badgecount_table _badgecount(get_self(), org.value);
+    auto badgecount_itr = _badgecount.find(badge_row.badge_symbol.code().raw());
+    if(badgecount_itr == _badgecount.end()) {
+      return badge_row.rarity_counts;
+    }
+    return badgecount_itr->rarity_counts;
+  }
+
+  void increment_rarity_counts(name org, const badge& badge_row, uint64_t amount) {
+    badgecount_table _badgecount(get_self(), org.value);
+    auto badgecount_itr = _badgecount.find(badge_row.badge_symbol.code().raw());
+    if(badgecount_itr == _badgecount.end()) {
+      _badgecount.emplace(get_self(), [&](auto& row) {
+        row.badge_symbol = badge_row.badge_symbol;
+        row.rarity_counts = badge_row.rarity_counts + amount;
+      });
+    } else {
+      _badgecount.modify(badgecount_itr, get_self(), [&](auto& row) {
+        row.rarity_counts += amount;
+      });
+    }
+  }
+
+  // scoped by contract
+  // consumers listed here with batch = true receive one notifybatch per achievebatch
+  // instead of one notifyachiev per issuance.
+  // compact = true switches per issuance delivery from notifyachiev to notifyachv2.
+  // pull = true stops push notifications, the consumer drains eventlogs instead.
+  // pull wins over batch and compact, in achievement and achievebatch alike.
+  TABLE notifycap {
+    name notify_account;
+    bool batch;
+    bool compact;
+    bool pull;
+    auto primary_key() const { return notify_account.value; }
+  };
+  typedef multi_index<name("notifycaps"), notifycap> notifycap_table;
+
+  notifycap get_notifycap(notifycap_table& _notifycap, name notify_account) {
+    auto notifycap_itr = _notifycap.find(notify_account.value);
+    if (notifycap_itr == _notifycap.end()) {
+      return notifycap { .notify_account = notify_account, .batch = false, .compact = false, .pull = false };
+    }
+    return *notifycap_itr;
+  }
+
+  // how achievebatch delivers the events of one badge. only the trailing batch capable
+  // consumers of notify_accounts are batched, their notifybatch runs after every per
+  // event notification, so no consumer runs ahead of one listed before it.
+  struct batch_delivery {
+    vector<notifycap> push_consumers;
+    vector<name> batch_consumers;
+    bool pull;
+  };
+
+  // scoped by contract
+  TABLE eventseq {
+    name org;
+    uint64_t last_event_seq;
+    auto primary_key() const { return org.value; }
+  };
+  typedef multi_index<name("eventseqs"), eventseq> eventseq_table;
+
+  uint64_t next_event_seq(name org) {
+    eventseq_table _eventseq(get_self(), get_self().value);
+    auto eventseq_itr = _eventseq.find(org.value);
+    if (eventseq_itr == _eventseq.end()) {
+      _eventseq.emplace(get_self(), [&](auto& row) {
+        row.org = org;
+        row.last_event_seq = 1;
+      });
+      return 1;
+    }
+    _eventseq.modify(eventseq_itr, get_self(), [&](auto& row) {
+      row.last_event_seq += 1;
+    });
+    return eventseq_itr->last_event_seq;
+  }
+
+  // scoped by org
+  // ring buffer, log_seq n lives in slot n % EVENT_LOG_SIZE and overwrites log_seq n - EVENT_LOG_SIZE.
+  TABLE eventlog {
+    uint64_t slot;
+    uint64_t log_seq;
+    symbol badge_symbol;
+    uint64_t amount;
+    name from;
+    name to;
+    auto primary_key() const { return slot; }
+  };
+  typedef multi_index<name("eventlogs"), eventlog> eventlog_table;
+
+  // scoped by contract
+  TABLE loghead {
+    name org;
+    uint64_t last_log_seq;
+    auto primary_key() const { return org.value; }
+  };
+  typedef multi_index<name("logheads"), loghead> loghead_table;
+
+  void append_event_log(name org, const achievement_event& event) {
+    loghead_table _loghead(get_self(), get_self().value);
+    auto loghead_itr = _loghead.find(org.value);
+    uint64_t log_seq = 1;
+    if (loghead_itr == _loghead.end()) {
+      _loghead.emplace(get_self(), [&](auto& row) {
+        row.org = org;
+        row.last_log_seq = log_seq;
+      });
+    } else {
+      log_seq = loghead_itr->last_log_seq + 1;
+      _loghead.modify(loghead_itr, get_self(), [&](auto& row) {
+        row.last_log_seq = log_seq;
+      });
+    }
+
+    eventlog_table _eventlog(get_self(), org.value);
+    uint64_t slot = log_seq % EVENT_LOG_SIZE;
+    auto eventlog_itr = _eventlog.find(slot);
+    auto write_event = [&](auto& row) {
+      row.slot = slot;
+      row.log_seq = log_seq;
+      row.badge_symbol = event.badge_asset.symbol;
+      row.amount = event.badge_asset.amount;
+      row.from = event.from;
+      row.to = event.to;
+    };
+    if (eventlog_itr == _eventlog.end()) {
+      _eventlog.emplace(get_self(), write_event);
+    } else {
+      _eventlog.modify(eventlog_itr, get_self(), write_event);
+    }
+  }
+
+  // consumers are notified in notify_accounts order, since later consumers read the
+  // tables of earlier ones. a run of legacy consumers shares one notifyachiev, each
+  // compact consumer gets its own notifyachv2 in its place in the run.
+  void notify_issuance(name org, const achievement_event& event, const vector<notifycap>& consumers) {
+    vector<name> legacy_accounts;
+    uint64_t event_seq = 0;
+    std::optional<checksum256> memo_hash;
+    for (size_t i = 0; i <= consumers.size(); i++) {
+      if (i < consumers.size() && !consumers[i].compact) {
+        legacy_accounts.push_back(consumers[i].notify_account);
+        continue;
+      }
+      if (!legacy_accounts.empty()) {
+        action {
+          permission_level{get_self(), name("active")},
+          get_self(),
+          name("notifyachiev"),
+          notifyachievement_args {
+            .org = org,
+            .badge_asset = event.badge_asset,
+            .from = event.from,
+            .to = event.to,
+            .memo = event.memo,
+            .notify_accounts = legacy_accounts
+          }
+        }.send();
+        legacy_accounts.clear();
+      }
+      if (i == consumers.size()) {
+        break;
+      }
+
+      // one event_seq per issuance, shared by its compact consumers
+      if (event_seq == 0) {
+        event_seq = next_event_seq(org);
+        if (!event.memo.empty()) {
+          memo_hash = sha256(event.memo.data(), event.memo.size());
+        }
+      }
+      action {
+        permission_level{get_self(), name("active")},
+        get_self(),
+        name("notifyachv2"),
+        notifyachv2_args {
+          .org = org,
+          .notify_account = consumers[i].notify_account,
+          .badge_symbol = event.badge_asset.symbol,
+          .amount = static_cast<uint64_t>(event.badge_asset.amount),
+          .from = event.from,
+          .to = event.to,
+          .event_seq = event_seq,
+          .memo_hash = memo_hash
+        }
+      }.send();
+    }
+  }
+
   TABLE orgcode {
     name org;         // Organization identifier, used as primary key
     name org_code;    // Converted org_code, ensuring uniqueness and specific format
@@ -65,7 +65,7 @@ ACTION metadata::addfeature(
             .memo = memo,
             .offchain_lookup_data = badge_iterator->offchain_lookup_data,
             .onchain_lookup_data = badge_iterator->onchain_lookup_data,
-            .rarity_counts = badge_iterator->rarity_counts
+            .rarity_counts = get_rarity_counts(org, *badge_iterator)
         }
     }.send();
 }
@@ -119,7 +119,7 @@ ACTION metadata::delfeature(
             .memo = memo,
             .offchain_lookup_data = badge_iterator->offchain_lookup_data,
             .onchain_lookup_data = badge_iterator->onchain_lookup_data,
-            .rarity_counts = badge_iterator->rarity_counts
+            .rarity_counts = get_rarity_counts(org, *badge_iterator)
         }
     }.send();
 }
@@ -153,23 +153,29 @@ ACTION metadata::achievement(
     auto badge_iterator = _badge.find(badge_asset.symbol.code().raw());
     check(badge_iterator != _badge.end(), failure_identifier + " symbol for asset not initialized ");
 
-    _badge.modify(badge_iterator, get_self(), [&](auto& row) {
-        row.rarity_counts += badge_asset.amount;
-    });
-
-    action {
-        permission_level{get_self(), name("active")},
-        get_self(),
-        name("notifyachiev"),
-        notifyachievement_args {
-            .org = org,
-            .badge_asset = badge_asset,
-            .from = from,
-            .to = to,
-            .memo = memo,
-            .notify_accounts = badge_iterator->notify_accounts
+    increment_rarity_counts(org, *badge_iterator, badge_asset.amount);
+
+    notifycap_table _notifycap(get_self(), get_self().value);
+    vector<notifycap> push_consumers;
+    bool pull = false;
+    for (auto& notify_account : badge_iterator->notify_accounts) {
+        notifycap cap = get_notifycap(_notifycap, notify_account);
+        if (cap.pull) {
+            pull = true;
+        } else {
+            push_consumers.push_back(cap);
         }
-    }.send();    
+    }
+
+    achievement_event event {
+        .badge_asset = badge_asset,
+        .from = from,
+        .to = to,
+        .memo = memo };
+    notify_issuance(org, event, push_consumers);
+    if (pull) {
+        append_event_log(org, event);
+    }
 }
 
 ACTION metadata::mergeinfo(
@@ -228,3 +234,128 @@ ACTION metadata::notifyachiev(
     }
 
 }
+
+ACTION metadata::achievebatch(
+    name org,
+    vector<achievement_event> events) {
+
+    string action_name = "achievebatch";
+    string failure_identifier = "CONTRACT: metadata, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+    check(!events.empty(), failure_identifier + "no achievements in batch");
+
+    badge_table _badge(get_self(), org.value);
+    notifycap_table _notifycap(get_self(), get_self().value);
+
+    std::map<uint64_t, badge_table::const_iterator> badge_iterators;
+    std::map<uint64_t, batch_delivery> deliveries;
+    std::map<uint64_t, uint64_t> rarity_increments;
+    std::map<name, vector<achievement_event>> batched_events;
+    vector<name> batch_order;
+
+    for (auto& event : events) {
+        uint64_t badge_key = event.badge_asset.symbol.code().raw();
+        auto delivery_itr = deliveries.find(badge_key);
+        if (delivery_itr == deliveries.end()) {
+            auto badge_iterator = _badge.find(badge_key);
+            check(badge_iterator != _badge.end(), failure_identifier + " symbol for asset not initialized " + event.badge_asset.symbol.code().to_string());
+            badge_iterators.emplace(badge_key, badge_iterator);
+
+            batch_delivery delivery { .pull = false };
+            for (auto& notify_account : badge_iterator->notify_accounts) {
+                notifycap cap = get_notifycap(_notifycap, notify_account);
+                if (cap.pull) {
+                    delivery.pull = true;
+                } else {
+                    delivery.push_consumers.push_back(cap);
+                }
+            }
+            while (!delivery.push_consumers.empty() && delivery.push_consumers.back().batch) {
+                delivery.batch_consumers.insert(delivery.batch_consumers.begin(), delivery.push_consumers.back().notify_account);
+                delivery.push_consumers.pop_back();
+            }
+            delivery_itr = deliveries.emplace(badge_key, delivery).first;
+        }
+        rarity_increments[badge_key] += event.badge_asset.amount;
+
+        for (auto& notify_account : delivery_itr->second.batch_consumers) {
+            auto& consumer_events = batched_events[notify_account];
+            if (consumer_events.empty()) {
+                batch_order.push_back(notify_account);
+            }
+            consumer_events.push_back(event);
+        }
+        notify_issuance(org, event, delivery_itr->second.push_consumers);
+        if (delivery_itr->second.pull) {
+            append_event_log(org, event);
+        }
+    }
+
+    for (auto& [badge_key, amount] : rarity_increments) {
+        increment_rarity_counts(org, *badge_iterators[badge_key], amount);
+    }
+
+    for (auto& notify_account : batch_order) {
+        action {
+            permission_level{get_self(), name("active")},
+            get_self(),
+            name("notifybatch"),
+            notifybatch_args {
+                .org = org,
+                .notify_account = notify_account,
+                .events = batched_events[notify_account]
+            }
+        }.send();
+    }
+}
+
+ACTION metadata::notifybatch(
+    name org,
+    name notify_account,
+    vector<achievement_event> events) {
+
+    require_auth(get_self());
+    require_recipient(notify_account);
+}
+
+ACTION metadata::setnotifycap(
+    name notify_account,
+    bool batch,
+    bool compact,
+    bool pull) {
+
+    string action_name = "setnotifycap";
+    string failure_identifier = "CONTRACT: metadata, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    notifycap_table _notifycap(get_self(), get_self().value);
+    auto notifycap_itr = _notifycap.find(notify_account.value);
+    if (notifycap_itr == _notifycap.end()) {
+        _notifycap.emplace(get_self(), [&](auto& row) {
+            row.notify_account = notify_account;
+            row.batch = batch;
+            row.compact = compact;
+            row.pull = pull;
+        });
+    } else {
+        _notifycap.modify(notifycap_itr, get_self(), [&](auto& row) {
+            row.batch = batch;
+            row.compact = compact;
+            row.pull = pull;
+        });
+    }
+}
+
+ACTION metadata::notifyachv2(
+    name org,
+    name notify_account,
+    symbol badge_symbol,
+    uint64_t amount,
+    name from,
+    name to,
+    uint64_t event_seq,
+    std::optional<checksum256> memo_hash) {
+
+    require_auth(get_self());
+    require_recipient(notify_account);
+}
@@ -6,43 +6,16 @@ ACTION subscription::billing(name org, uint8_t actions_used) {
     string failure_identifier = "CONTRACT: subscription, ACTION: " + action_name + ", MESSAGE: ";
     check_internal_auth(name(action_name), failure_identifier);
 
-    // Open the orgpackage table scoped by the organization
-    orgpackage_table orgpackages(get_self(), org.value);
-
-    // Access the current package
-    auto status_index = orgpackages.get_index<"bystatus"_n>();
-    auto current_itr = status_index.find(name("current").value);
-    time_point_sec current_time = eosio::current_time_point();
-    // Check if a current package does not exist, is expired, or is exhausted
-    if (current_itr == status_index.end() ||
-        current_time > current_itr->expiry_time ||
-        current_itr->actions_used >= current_itr->total_actions_bought ||
-        current_itr->status != name("current")) {
-        // Handle expired or missing current package
-        auto new_itr = status_index.find(name("new").value);
-        check(new_itr != status_index.end(), "No NEW package available to update");
-
-        // Promote the NEW package to CURRENT
-        status_index.modify(new_itr, get_self(), [&](auto& new_pkg) {
-            new_pkg.status = "current"_n;
-            new_pkg.actions_used = actions_used; 
-            new_pkg.expiry_time = time_point_sec(current_time_point().sec_since_epoch() +
-                                                 new_pkg.expiry_duration_in_secs);
-        });
-
-        // Update the old current package to USED if it exists
-        if (current_itr != status_index.end() && current_itr->status == name("current")) {
-            status_index.modify(current_itr, get_self(), [&](auto& old_pkg) {
-                old_pkg.status = "used"_n;
-            });
-        }
-    } else {
-        // Increment actions used for the current package
-        status_index.modify(current_itr, get_self(), [&](auto& pkg) {
-            pkg.actions_used += actions_used;
-        });
-    }    
+    consume_actions(org, actions_used);
+}
+
+// used by consumers that bill a whole notification batch at once, where uint8_t would wrap
+ACTION subscription::billbulk(name org, uint64_t actions_used) {
+    string action_name = "billbulk";
+    string failure_identifier = "CONTRACT: subscription, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
 
+    consume_actions(org, actions_used);
 }
 
 void subscription::buypack(name from, name to, asset amount, std::string memo) {
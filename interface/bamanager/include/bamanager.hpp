@@ -17,7 +17,8 @@ CONTRACT bamanager : public contract {
     ACTION initagg(name authorized, symbol agg_symbol, vector<symbol> badge_symbols, vector<symbol> stats_badge_symbols, string agg_description);
     ACTION addinitbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols);
     ACTION reminitbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols);
-    ACTION addstatbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols);
+    // top_k > 0 ranks only the top_k highest balances of each sequence, 0 ranks every account
+    ACTION addstatbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols, uint16_t top_k);
     ACTION remstatbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols);
 
 
@@ -171,6 +172,7 @@ CONTRACT bamanager : public contract {
       name org;
       symbol agg_symbol;
       vector<symbol> badge_symbols;
+      uint16_t top_k;
     };
 
     struct stats_deactivate_args {
@@ -61,7 +61,8 @@ ACTION bamanager::initagg(name authorized, symbol agg_symbol, vector<symbol> bad
       stats_activate_args {
         .org = org,
         .agg_symbol = agg_symbol,
-        .badge_symbols = stats_badge_symbols
+        .badge_symbols = stats_badge_symbols,
+        .top_k = 0
       }
     }.send();
 }
@@ -143,7 +144,7 @@ ACTION bamanager::reminitbadge(name authorized, symbol agg_symbol, vector<symbol
       }
     }.send();
 }
-ACTION bamanager::addstatbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols) {
+ACTION bamanager::addstatbadge(name authorized, symbol agg_symbol, vector<symbol> badge_symbols, uint16_t top_k) {
     require_auth(authorized);
     string action_name = "addstatbadge";
     string failure_identifier = "CONTRACT: bamanager, ACTION: " + action_name + ", MESSAGE: ";
@@ -189,7 +190,8 @@ ACTION bamanager::addstatbadge(name authorized, symbol agg_symbol, vector<symbol
       stats_activate_args {
         .org = org,
         .agg_symbol = agg_symbol,
-        .badge_symbols = badge_symbols
+        .badge_symbols = badge_symbols,
+        .top_k = top_k
       }
     }.send();
 
@@ -129,4 +129,11 @@ CONTRACT simmanager : public contract {
       string memo;
     };
 
+    struct issuebatch_args {
+      name org;
+      asset badge_asset;
+      vector<name> to;
+      string memo;
+    };
+
 };
@@ -75,18 +75,16 @@
     notify_checks_contract(org);
     asset badge_asset(amount, badge_symbol);
     
-    for( auto i = 0; i < to.size(); i++ ) {
-      action {
-      permission_level{get_self(), name("active")},
-      name(SIMPLEBADGE_CONTRACT),
-      name("issue"),
-      issuesimple_args {
-        .org = org,
-        .badge_asset = badge_asset,
-        .to = to[i],
-        .memo = memo }
-      }.send();
-    }
+    action {
+    permission_level{get_self(), name("active")},
+    name(SIMPLEBADGE_CONTRACT),
+    name("issuebatch"),
+    issuebatch_args {
+      .org = org,
+      .badge_asset = badge_asset,
+      .to = to,
+      .memo = memo }
+    }.send();
   }
 
 
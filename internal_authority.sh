@@ -50,6 +50,8 @@ push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "initbadge" "$SI
 push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "addfeature" "$SIMPLE_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$SIMPLEBADGE_CONTRACT" "issue" "$SIMPLE_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "achievement" "$SIMPLEBADGE_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$SIMPLEBADGE_CONTRACT" "issuebatch" "$SIMPLE_MANAGER_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "achievebatch" "$SIMPLEBADGE_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$ANDEMITTER_CONTRACT" "newemission" "$ANDEMITTER_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "addfeature" "$ANDEMITTER_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$ANDEMITTER_CONTRACT" "activate" "$ANDEMITTER_MANAGER_CONTRACT"
@@ -74,6 +76,20 @@ push_transaction "$AUTHORITY_CONTRACT" "$GIVER_REP_CONTRACT" "activate" "$GIVER_
 push_transaction "$AUTHORITY_CONTRACT" "$SIMPLEBADGE_CONTRACT" "issue" "$GIVER_REP_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_AGG_CONTRACT" "addinitbadge" "$BOUNDED_AGG_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_AGG_CONTRACT" "endseq" "$BOUNDED_AGG_MANAGER_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_AGG_CONTRACT" "migratebs" "$BOUNDED_AGG_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$STATISTICS_CONTRACT" "migrateranks" "$STATISTICS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$STATISTICS_CONTRACT" "settopk" "$STATISTICS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_STATS_CONTRACT" "migrateranks" "$BOUNDED_STATS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$STATISTICS_CONTRACT" "freeranks" "$STATISTICS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_STATS_CONTRACT" "freeranks" "$BOUNDED_STATS_CONTRACT"
+# metadata notify capabilities are set by the orchestrator account itself
+push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "setnotifycap" "$ORCHESTRATOR_CONTRACT"
+# billbulk: cumulative notifybatch, statistics and boundedstats notifybatch and crank,
+# boundagg notifybatch, addbadge and bulk jobs (actseqai, endseqaa, addbadgeai, addbadgeaa, runjob)
+push_transaction "$AUTHORITY_CONTRACT" "$SUBSCRIPTION_CONTRACT" "billbulk" "$CUMULATIVE_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$SUBSCRIPTION_CONTRACT" "billbulk" "$STATISTICS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$SUBSCRIPTION_CONTRACT" "billbulk" "$BOUNDED_STATS_CONTRACT"
+push_transaction "$AUTHORITY_CONTRACT" "$SUBSCRIPTION_CONTRACT" "billbulk" "$BOUNDED_AGG_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$ORCHESTRATOR_CONTRACT" "addfeature" "$BOUNDED_HLL_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_HLL_CONTRACT" "newemission" "$BOUNDED_HLL_MANAGER_CONTRACT"
 push_transaction "$AUTHORITY_CONTRACT" "$BOUNDED_HLL_CONTRACT" "activate" "$BOUNDED_HLL_MANAGER_CONTRACT"
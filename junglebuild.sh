@@ -86,7 +86,7 @@ cd ../..
 
 #cd consumers/rounds
 #cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DBILLING_CONTRACT=$BILLING_CONTRACT
-#eosio-cpp -abigen -I ./include -R ./resource -contract rounds -o rounds.wasm src/rounds.cpp
+#eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract rounds -o rounds.wasm src/rounds.cpp
 #cd ../..
 
 cd consumers/aabadge
@@ -111,7 +111,7 @@ cd ../..
 
 cd consumers/statistics
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DCUMULATIVE_CONTRACT_NAME=$CUMULATIVE_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract statistics -o statistics.wasm src/statistics.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract statistics -o statistics.wasm src/statistics.cpp
 cd ../..
 
 cd org
@@ -52,7 +52,7 @@ cd ../..
 
 cd consumers/rounds
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DBILLING_CONTRACT=$BILLING_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract rounds -o rounds.wasm src/rounds.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract rounds -o rounds.wasm src/rounds.cpp
 cd ../..
 
 cd consumers/aabadge
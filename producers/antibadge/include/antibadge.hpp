@@ -65,16 +65,16 @@ private:
         uint64_t primary_key() const { return badge_agg_seq_id; }
         uint128_t by_agg_seq() const { return combine_keys(agg_symbol.code().raw(), seq_id); }
 
-        checksum256 by_badge_status() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
-            return sha256(data.data(), data.size());
+        // secondary keys pack the raw values into the words of a checksum256, nothing is hashed
+        checksum256 by_badge_status() const { return badge_status_key(badge_symbol, badge_status, seq_status); }
+        checksum256 by_agg_seq_badge() const { return agg_seq_badge_key(agg_symbol, seq_id, badge_symbol); }
+
+        static checksum256 badge_status_key(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
+            return checksum256::make_from_word_sequence<uint64_t>(badge_symbol.code().raw(), badge_status.value, seq_status.value, uint64_t(0));
         }
 
-        checksum256 by_agg_seq_badge() const {
-            // Example hashing for badge status; adjust according to actual implementation needs
-            auto data = agg_symbol.code().to_string() + std::to_string(seq_id) + badge_symbol.code().to_string();
-            return sha256(data.data(), data.size());
+        static checksum256 agg_seq_badge_key(const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+            return checksum256::make_from_word_sequence<uint64_t>(agg_symbol.code().raw(), seq_id, badge_symbol.code().raw(), uint64_t(0));
         }
 
         static uint128_t combine_keys(uint64_t a, uint64_t b) {
@@ -88,6 +88,88 @@ private:
         eosio::indexed_by<"aggseqbadge"_n, eosio::const_mem_fun<badgestatus, checksum256, &badgestatus::by_agg_seq_badge>>
     > badgestatus_table;
 
+    // scoped by boundagg contract, rows past last_badge_agg_seq_id still carry the legacy sha256 keys until done
+    TABLE bsmigration {
+        name org;
+        uint64_t last_badge_agg_seq_id;
+        bool done;
+        auto primary_key() const { return org.value; }
+    };
+    typedef multi_index<name("bsmigration"), bsmigration> bsmigration_table;
+
+    bool badgestatus_migrated(name org) {
+        bsmigration_table _bsmigration(name(BOUNDED_AGG_CONTRACT), name(BOUNDED_AGG_CONTRACT).value);
+        auto bsmigration_itr = _bsmigration.find(org.value);
+        return bsmigration_itr != _bsmigration.end() && bsmigration_itr->done;
+    }
+
+    struct routeentry {
+        uint64_t badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+    };
+
+    // scoped by org, see boundagg::activeroute
+    TABLE activeroute {
+        symbol badge_symbol;
+        vector<routeentry> routes;
+        auto primary_key() const { return badge_symbol.code().raw(); }
+    };
+    typedef multi_index<name("activeroutes"), activeroute> activeroute_table;
+
+    // scoped by org, init badges a sequence of a migrated org inherits, see boundagg::seqinherit
+    TABLE seqinherit {
+        uint64_t first_badge_agg_seq_id;
+        symbol agg_symbol;
+        uint64_t seq_id;
+        vector<symbol> badge_symbols;
+        uint64_t primary_key() const { return first_badge_agg_seq_id; }
+        uint128_t by_agg_seq() const { return badgestatus::combine_keys(agg_symbol.code().raw(), seq_id); }
+    };
+    typedef multi_index<name("seqinherits"), seqinherit,
+        indexed_by<"byaggseq"_n, const_mem_fun<seqinherit, uint128_t, &seqinherit::by_agg_seq>>
+    > seqinherit_table;
+
+    // badge_agg_seq_id the sequence reserved for badge_symbol, 0 if it does not inherit it
+    uint64_t inherited_badge_agg_seq_id(name org, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+        seqinherit_table _seqinherit(name(BOUNDED_AGG_CONTRACT), org.value);
+        auto by_agg_seq_index = _seqinherit.get_index<"byaggseq"_n>();
+        auto itr = by_agg_seq_index.find(badgestatus::combine_keys(agg_symbol.code().raw(), seq_id));
+        if(itr == by_agg_seq_index.end()) {
+            return 0;
+        }
+        auto badge_itr = std::find(itr->badge_symbols.begin(), itr->badge_symbols.end(), badge_symbol);
+        if(badge_itr == itr->badge_symbols.end()) {
+            return 0;
+        }
+        return itr->first_badge_agg_seq_id + (badge_itr - itr->badge_symbols.begin());
+    }
+
+    // active (badge, sequence) pairs of badge_symbol, see boundagg::active_routes
+    vector<routeentry> active_routes(name org, const symbol& badge_symbol) {
+        if(badgestatus_migrated(org)) {
+            activeroute_table _activeroute(name(BOUNDED_AGG_CONTRACT), org.value);
+            auto activeroute_itr = _activeroute.find(badge_symbol.code().raw());
+            return activeroute_itr == _activeroute.end() ? vector<routeentry>() : activeroute_itr->routes;
+        }
+
+        vector<routeentry> routes;
+        badgestatus_table badgestatus_t(name(BOUNDED_AGG_CONTRACT), org.value);
+        auto by_status_index = badgestatus_t.get_index<"bybadgestat"_n>();
+        vector<checksum256> keys = {
+            badgestatus::badge_status_key(badge_symbol, "active"_n, "active"_n),
+            hash_active_status(badge_symbol, "active"_n, "active"_n)};
+        for(auto& key : keys) {
+            auto itr = by_status_index.find(key);
+            while(itr != by_status_index.end() && itr->badge_symbol == badge_symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
+                routes.push_back({itr->badge_agg_seq_id, itr->agg_symbol, itr->seq_id});
+                itr++;
+            }
+        }
+        return routes;
+    }
+
+    // legacy sha256 keys, only used for rows not yet re-indexed by boundagg::migratebs
     checksum256 hash_active_status(const symbol& badge_symbol, const name& badge_status, const name& seq_status) {
         // Create a data string from badge_symbol, badge_status, and seq_status
         string data_str = badge_symbol.code().to_string() + badge_status.to_string() + seq_status.to_string();
@@ -104,6 +186,30 @@ private:
         return sha256(data_str.data(), data_str.size());
     }
 
+    // aggseqbadge lookup, falls back to the legacy key while the org is not migrated
+    template<typename Index>
+    auto find_agg_seq_badge(Index& index, bool migrated, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+        auto itr = index.find(badgestatus::agg_seq_badge_key(agg_symbol, seq_id, badge_symbol));
+        if(itr == index.end() && !migrated) {
+            itr = index.find(hash_agg_seq_badge(agg_symbol, seq_id, badge_symbol));
+        }
+        return itr;
+    }
+
+    // badge_agg_seq_id of badge_symbol in (agg_symbol, seq_id), from its badgestatus row or,
+    // in a migrated org, from the ids the sequence reserved for its inherited badges. 0 if none.
+    template<typename Index>
+    uint64_t agg_seq_badge_id(Index& index, bool migrated, name org, const symbol& agg_symbol, uint64_t seq_id, const symbol& badge_symbol) {
+        auto itr = find_agg_seq_badge(index, migrated, agg_symbol, seq_id, badge_symbol);
+        if(itr != index.end() &&
+            agg_symbol == itr->agg_symbol &&
+            seq_id == itr->seq_id &&
+            badge_symbol == itr->badge_symbol) {
+            return itr->badge_agg_seq_id;
+        }
+        return migrated ? inherited_badge_agg_seq_id(org, agg_symbol, seq_id, badge_symbol) : 0;
+    }
+
     TABLE achievements {
         uint64_t badge_agg_seq_id;
         uint64_t count;
@@ -171,44 +171,31 @@ ACTION antibadge::chkbndissue (asset anti_badge_asset, name account) {
     achievements_table achievements(name(BOUNDED_AGG_CONTRACT), account.value);
 
     badgestatus_table badgestatus(name(BOUNDED_AGG_CONTRACT), org.value);
-    auto by_status_index = badgestatus.get_index<"bybadgestat"_n>();
-    auto hashed_active_status = hash_active_status(anti_badge_asset.symbol, "active"_n, "active"_n);
-    auto itr = by_status_index.find(hashed_active_status);
-    
-    while(itr != by_status_index.end() && itr->badge_symbol == anti_badge_asset.symbol && itr->badge_status == "active"_n && itr->seq_status == "active"_n) {
+    auto by_agg_seq_badge_index = badgestatus.get_index<"aggseqbadge"_n>();
+    bool migrated = badgestatus_migrated(org);
+    vector<routeentry> routes = active_routes(org, anti_badge_asset.symbol);
+
+    for(auto itr = routes.begin(); itr != routes.end(); itr++) {
         symbol agg_symbol = itr->agg_symbol;
         uint64_t seq_id = itr->seq_id;
         uint64_t badge_balance = 0;
         uint64_t anti_badge_balance = 0;
-        
-        auto by_agg_seq_badge_index = badgestatus.get_index<"aggseqbadge"_n>();
 
-        auto badge_hashed_key = hash_agg_seq_badge(itr->agg_symbol, itr->seq_id, badge_symbol);
-        auto badge_itr = by_agg_seq_badge_index.find(badge_hashed_key);
-
-        if( badge_itr != by_agg_seq_badge_index.end() && 
-            agg_symbol == badge_itr->agg_symbol && 
-            seq_id == badge_itr->seq_id && 
-            badge_symbol == badge_itr->badge_symbol) {
-            auto ach_itr = achievements.find(badge_itr->badge_agg_seq_id);
+        // a badge the sequence tracks but the account never received counts as 0
+        uint64_t badge_agg_seq_id = agg_seq_badge_id(by_agg_seq_badge_index, migrated, org, agg_symbol, seq_id, badge_symbol);
+        if(badge_agg_seq_id != 0) {
+            auto ach_itr = achievements.find(badge_agg_seq_id);
             badge_balance = (ach_itr == achievements.end()) ? 0 : ach_itr->count;
         }
         for(auto i = 0 ; i < anti_badge_symbols.size(); i++) {
-            auto antibadge_hashed_key = hash_agg_seq_badge(itr->agg_symbol, itr->seq_id, anti_badge_symbols[i]);
-            auto anti_badge_itr = by_agg_seq_badge_index.find(antibadge_hashed_key);
-            if( anti_badge_itr != by_agg_seq_badge_index.end() && 
-                agg_symbol == anti_badge_itr->agg_symbol && 
-                seq_id == anti_badge_itr->seq_id && 
-                anti_badge_symbols[i] == anti_badge_itr->badge_symbol) {
-
-                auto ach_itr = achievements.find(anti_badge_itr->badge_agg_seq_id);
-                anti_badge_balance = anti_badge_balance + (ach_itr == achievements.end()) ? 0 : ach_itr->count;
+            uint64_t anti_badge_agg_seq_id = agg_seq_badge_id(by_agg_seq_badge_index, migrated, org, agg_symbol, seq_id, anti_badge_symbols[i]);
+            if(anti_badge_agg_seq_id != 0) {
+                auto ach_itr = achievements.find(anti_badge_agg_seq_id);
+                anti_badge_balance = anti_badge_balance + ((ach_itr == achievements.end()) ? 0 : ach_itr->count);
             }
-
         }
         
         check(anti_badge_balance + anti_badge_asset.amount <= badge_balance, "CHECK FAILED: cumulative balance of all antibadges will exceed the badge balance for agg : " + agg_symbol.code().to_string() + " seq id:" + std::to_string(seq_id));
-        itr++;
     }
 
 
@@ -21,6 +21,8 @@ CONTRACT simplebadge : public contract {
 
     ACTION issue (name org, asset badge_asset, name to, string memo );
 
+    ACTION issuebatch (name org, asset badge_asset, vector<name> to, string memo );
+
 
   private:
     // scoped by contract
@@ -52,6 +54,18 @@ CONTRACT simplebadge : public contract {
       string memo;
     };
 
+    struct achievement_event {
+      asset badge_asset;
+      name from;
+      name to;
+      string memo;
+    };
+
+    struct achievebatch_args {
+      name org;
+      vector<achievement_event> events;
+    };
+
     struct initbadge_args {
       name org;
       symbol badge_symbol;
@@ -59,3 +59,27 @@
   }
 
     
+
+  ACTION simplebadge::issuebatch (name org, asset badge_asset, vector<name> to, string memo) {
+    string action_name = "issuebatch";
+    string failure_identifier = "CONTRACT: simplebadge, ACTION: " + action_name + ", MESSAGE: ";
+    check_internal_auth(name(action_name), failure_identifier);
+
+    vector<achievement_event> events;
+    for (auto i = 0; i < to.size(); i++) {
+      events.push_back(achievement_event {
+        .badge_asset = badge_asset,
+        .from = get_self(),
+        .to = to[i],
+        .memo = memo });
+    }
+
+    action {
+      permission_level{get_self(), name("active")},
+      name(ORCHESTRATOR_CONTRACT),
+      name("achievebatch"),
+      achievebatch_args {
+        .org = org,
+        .events = events }
+    }.send();
+  }
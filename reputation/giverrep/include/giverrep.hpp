@@ -1,5 +1,6 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
+#include <eventlog.hpp>
 
 using namespace std;
 using namespace eosio;
@@ -13,6 +14,7 @@ using namespace eosio;
 
 #define NEW_BADGE_ISSUANCE_NOTIFICATION ORCHESTRATOR_CONTRACT"::notifyachiev"
 
+
 CONTRACT giverrep : public contract {
   public:
     using contract::contract;
@@ -37,6 +39,8 @@ CONTRACT giverrep : public contract {
 
     ACTION deactivate(name org, symbol badge_symbol);
 
+    ACTION crank(name org, uint16_t max_events);
+
   private:
     // scoped by self
     TABLE emissions {
@@ -129,6 +133,9 @@ CONTRACT giverrep : public contract {
         check(org == badge_org, failure_identifier + " org not same as in badge_symbol");
     }
 
+    // issues emit_badge_symbols to the recipient scaled by the giver's balance against the mean
+    void emit_giver_rep(name org, emissions_table::const_iterator existing_emission, name from, name to, string failure_identifier);
+
     struct issue_args {
       name org;
       asset badge_asset;
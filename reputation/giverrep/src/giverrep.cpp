@@ -18,6 +18,32 @@ void giverrep::notifyachiev (
     // Ensure that the emission does not already exist
     eosio::check(existing_emission != emissions.end(), "Giver rep badge not setup");
 
+    emit_giver_rep(org, existing_emission, from, to, failure_identifier);
+}
+
+ACTION giverrep::crank(name org, uint16_t max_events) {
+    string action_name = "crank";
+    string failure_identifier = "CONTRACT: giverrep, ACTION: " + action_name + ", MESSAGE: ";
+
+    uint64_t head_log_seq = 0;
+    eventlog_reader event_log(get_self(), name(ORCHESTRATOR_CONTRACT));
+    vector<eventlog> events = event_log.drain(org, max_events, head_log_seq);
+
+    emissions_table emissions(_self, _self.value);
+    std::map<uint64_t, bool> followed_badges;
+    for(auto& event : events) {
+        if(!event_log.follows_badge(org, event.badge_symbol, followed_badges)) {
+            continue;
+        }
+        // an event without emission is skipped rather than failing, a failing crank would never advance
+        auto existing_emission = emissions.find(event.badge_symbol.code().raw());
+        if(existing_emission != emissions.end()) {
+            emit_giver_rep(org, existing_emission, event.from, event.to, failure_identifier);
+        }
+    }
+}
+
+void giverrep::emit_giver_rep(name org, emissions_table::const_iterator existing_emission, name from, name to, string failure_identifier) {
     if(existing_emission->status != name("active")) {
         return;
     }
@@ -140,12 +140,12 @@ cd ../..
 
 cd $BOUNDEDSTATS_PATH
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DBOUNDED_AGG_CONTRACT_NAME=$BOUNDED_AGG_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract boundedstats -o boundedstats.wasm src/boundedstats.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract boundedstats -o boundedstats.wasm src/boundedstats.cpp
 cd ../..
 
 cd $BOUNDEDHLL_PATH
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DNOTIFICATION_CONTRACT_NAME=$NOTIFICATION_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract boundedhll -o boundedhll.wasm src/boundedhll.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract boundedhll -o boundedhll.wasm src/boundedhll.cpp
 cd ../..
 
 cd $DEFERRED_PATH
@@ -170,18 +170,18 @@ cd ../..
 
 cd $STATISTICS_PATH
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DCUMULATIVE_CONTRACT_NAME=$CUMULATIVE_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract statistics -o statistics.wasm src/statistics.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract statistics -o statistics.wasm src/statistics.cpp
 cd ../..
 
 cd $HLLEMITTER_PATH
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DNOTIFICATION_CONTRACT_NAME=$NOTIFICATION_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract hllemitter -o hllemitter.wasm src/hllemitter.cpp
+eosio-cpp -abigen -I ./include -I ../common/include -R ./resource -contract hllemitter -o hllemitter.wasm src/hllemitter.cpp
 cd ../..
 
 
 cd $GIVERREP_PATH
 cmake . -DORCHESTRATOR_CONTRACT_NAME=$ORCHESTRATOR_CONTRACT -DSTATS_CONTRACT_NAME=$STATISTICS_CONTRACT -DCUMULATIVE_CONTRACT_NAME=$CUMULATIVE_CONTRACT  -DNOTIFICATION_CONTRACT_NAME=$NOTIFICATION_CONTRACT
-eosio-cpp -abigen -I ./include -R ./resource -contract giverrep -o giverrep.wasm src/giverrep.cpp
+eosio-cpp -abigen -I ./include -I ../../consumers/common/include -R ./resource -contract giverrep -o giverrep.wasm src/giverrep.cpp
 cd ../..
 
 cd $ANDEMITTER_PATH
@@ -99,6 +99,8 @@ CUMULATIVE_PATH="consumers/cumulative"
 STATISTICS_PATH="consumers/statistics"
 HLLEMITTER_PATH="consumers/hllemitter"
 GIVERREP_PATH="reputation/giverrep"
+# shared consumer headers, for contracts outside consumers/
+COMMON_INCLUDE_PATH="$(pwd)/consumers/common/include"
 ANDEMITTER_PATH="consumers/andemitter"
 NOTIFICATION_PATH="core/notification"
 AUTHORITY_PATH="core/authority"
@@ -146,7 +148,7 @@ build_contract() {
     if should_process $contract_name && ([ "$ACTION" = "build" ] || [ "$ACTION" = "both" ]); then
         pushd $contract_path > /dev/null
         cmake . $cmake_params
-        eosio-cpp -abigen -I ./include -R ./resource -contract $contract_name -o ${contract_name}.wasm src/${contract_name}.cpp
+        eosio-cpp -abigen -I ./include -I ../common/include -I $COMMON_INCLUDE_PATH -R ./resource -contract $contract_name -o ${contract_name}.wasm src/${contract_name}.cpp
         popd > /dev/null
     fi
 }
@@ -57,6 +57,8 @@ BOUNDED_STATS_CONTRACT_PATH="consumers/boundedstats"
 
 HLL_EMITTER_CONTRACT_PATH="consumers/hllemitter"
 GIVER_REP_CONTRACT_PATH="reputation/giverrep"
+# shared consumer headers, for contracts outside consumers/
+COMMON_INCLUDE_PATH="$(pwd)/consumers/common/include"
 BOUNDED_HLL_CONTRACT_PATH="consumers/boundedhll"
 
 SUBSCRIPTION_CONTRACT_PATH="core/subscription"
@@ -126,7 +128,7 @@ build_contract() {
     if should_process $contract_name && ([ "$ACTION" = "build" ] || [ "$ACTION" = "both" ]); then
         pushd $contract_path > /dev/null
         cmake . $cmake_params
-        eosio-cpp -abigen -I ./include -R ./resource -contract $contract_name -o ${contract_name}.wasm src/${contract_name}.cpp
+        eosio-cpp -abigen -I ./include -I ../common/include -I $COMMON_INCLUDE_PATH -R ./resource -contract $contract_name -o ${contract_name}.wasm src/${contract_name}.cpp
         popd > /dev/null
     fi
 }